@@ -0,0 +1,234 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "AnalysisDataFile.h"
+
+#ifdef __GNUC__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define ANALYSIS_DATA_MAGIC "RCPSPCOL"
+#define ANALYSIS_DATA_VERSION 1
+// Magic, version, number of activities, and number of columns.
+#define HEADER_SIZE 20
+// Parameter, type, and offset of the column.
+#define DIRECTORY_ENTRY_SIZE 16
+#define INTEGRAL_COLUMN 0
+#define REAL_COLUMN 1
+
+using namespace std;
+
+uint64_t AnalysisDataFile::alignedSize(uint64_t size)	{
+	return (size+7) & ~((uint64_t) 7);
+}
+
+template <class T>
+void AnalysisDataFile::writeValue(BufferedWriter& output, const T& value)	{
+	output.write((const char*) &value, sizeof(T));
+}
+
+template <class T>
+T AnalysisDataFile::readValue(const char *data)	{
+	T value;
+	memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+template <class T>
+vector<double> AnalysisDataFile::normalizeColumn(const T *column, uint32_t numberOfValues)	{
+	vector<double> normalized;
+	if (numberOfValues == 0)
+		return normalized;
+
+	double maxValue = *max_element(column, column+numberOfValues);
+	for (uint32_t i = 0; i < numberOfValues; ++i)
+		normalized.push_back(((double) column[i])/maxValue);
+	return normalized;
+}
+
+void AnalysisDataFile::write(const string& file, const ParameterTable& table)	{
+	uint32_t numberOfActivities = table.activitiesFreedom.size();
+	vector<uint32_t> parameters, types;
+	for (uint32_t p = 0; p < NUMBER_OF_PARAMETERS; ++p)	{
+		if (p == ACTIVITY_FREEDOM)	{
+			parameters.push_back(p);
+			types.push_back(REAL_COLUMN);
+		} else if (table.integralColumns[p].size() == numberOfActivities)	{
+			parameters.push_back(p);
+			types.push_back(INTEGRAL_COLUMN);
+		}
+	}
+
+	uint32_t numberOfColumns = parameters.size();
+	BufferedWriter output(file);
+	output.write(ANALYSIS_DATA_MAGIC, 8);
+	writeValue<uint32_t>(output, ANALYSIS_DATA_VERSION);
+	writeValue<uint32_t>(output, numberOfActivities);
+	writeValue<uint32_t>(output, numberOfColumns);
+
+	uint64_t offset = alignedSize(HEADER_SIZE+((uint64_t) numberOfColumns)*DIRECTORY_ENTRY_SIZE);
+	for (uint32_t c = 0; c < numberOfColumns; ++c)	{
+		writeValue<uint32_t>(output, parameters[c]);
+		writeValue<uint32_t>(output, types[c]);
+		writeValue<uint64_t>(output, offset);
+		offset += alignedSize(((uint64_t) numberOfActivities)*(types[c] == REAL_COLUMN ? sizeof(double) : sizeof(uint32_t)));
+	}
+
+	const char padding[8] = { 0 };
+	output.write(padding, alignedSize(output.getPosition())-output.getPosition());
+	for (uint32_t c = 0; c < numberOfColumns; ++c)	{
+		if (numberOfActivities > 0)	{
+			if (types[c] == REAL_COLUMN)
+				output.write((const char*) &table.activitiesFreedom[0], numberOfActivities*sizeof(double));
+			else
+				output.write((const char*) &table.integralColumns[parameters[c]][0], numberOfActivities*sizeof(uint32_t));
+		}
+		output.write(padding, alignedSize(output.getPosition())-output.getPosition());
+	}
+
+	output.close();
+}
+
+AnalysisDataFile::AnalysisDataFile(const string& file) : mappedFile(NULL), mappedSize(0), numberOfActivities(0)	{
+	fill(integralColumns, integralColumns+NUMBER_OF_PARAMETERS, (const uint32_t*) NULL);
+	fill(realColumns, realColumns+NUMBER_OF_PARAMETERS, (const double*) NULL);
+
+	if (!mapFile(file))
+		throw invalid_argument("AnalysisDataFile::AnalysisDataFile: Cannot open the file "+file+"!");
+
+	if (!setColumnViews())	{
+		unmapFile();
+		throw runtime_error("AnalysisDataFile::AnalysisDataFile: Invalid format of the file "+file+"!");
+	}
+}
+
+AnalysisDataFile::~AnalysisDataFile()	{
+	unmapFile();
+}
+
+const uint32_t* AnalysisDataFile::getIntegralColumn(Parameter parameter) const	{
+	return (parameter < NUMBER_OF_PARAMETERS ? integralColumns[parameter] : NULL);
+}
+
+const double* AnalysisDataFile::getRealColumn(Parameter parameter) const	{
+	return (parameter < NUMBER_OF_PARAMETERS ? realColumns[parameter] : NULL);
+}
+
+InstanceResults AnalysisDataFile::getInstanceResults() const	{
+	InstanceResults results;
+	results.numberOfColumns = numberOfActivities;
+	// The order of the activities and their start times are not analysed.
+	for (uint32_t p = ACTIVITY_DURATION; p < NUMBER_OF_PARAMETERS; ++p)	{
+		ParameterResult result;
+		if (integralColumns[p] != NULL)
+			result.parameterValues = normalizeColumn(integralColumns[p], numberOfActivities);
+		else if (realColumns[p] != NULL)
+			result.parameterValues = normalizeColumn(realColumns[p], numberOfActivities);
+		else
+			continue;
+
+		result.description = VisualizerScheduleStatistics::getParameterDescription((Parameter) p);
+		results.results[(Parameter) p] = result;
+	}
+	return results;
+}
+
+bool AnalysisDataFile::mapFile(const string& file)	{
+	#ifdef __GNUC__
+	int fd = open(file.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat fileStatus;
+	if (fstat(fd, &fileStatus) == -1 || !S_ISREG(fileStatus.st_mode))	{
+		close(fd);
+		return false;
+	}
+
+	mappedSize = fileStatus.st_size;
+	if (mappedSize > 0)	{
+		void *mapping = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED)	{
+			close(fd);
+			return false;
+		}
+		mappedFile = mapping;
+	}
+	close(fd);
+	#else
+	ifstream input(file.c_str(), ios::in | ios::binary);
+	if (!input.good())
+		return false;
+
+	input.seekg(0, ios::end);
+	mappedSize = input.tellg();
+	input.seekg(0, ios::beg);
+	// The 64-bit words keep the columns aligned as in the mapping.
+	fileContent.resize(mappedSize/sizeof(uint64_t)+1);
+	if (mappedSize > 0 && input.read((char*) &fileContent[0], mappedSize).fail())
+		return false;
+	mappedFile = &fileContent[0];
+	#endif
+
+	return true;
+}
+
+void AnalysisDataFile::unmapFile()	{
+	#ifdef __GNUC__
+	if (mappedFile != NULL)
+		munmap(mappedFile, mappedSize);
+	#endif
+	mappedFile = NULL;
+	mappedSize = 0;
+}
+
+bool AnalysisDataFile::setColumnViews()	{
+	const char *data = (const char*) mappedFile;
+	if (mappedSize < HEADER_SIZE || memcmp(data, ANALYSIS_DATA_MAGIC, 8) != 0 || readValue<uint32_t>(data+8) != ANALYSIS_DATA_VERSION)
+		return false;
+
+	numberOfActivities = readValue<uint32_t>(data+12);
+	uint32_t numberOfColumns = readValue<uint32_t>(data+16);
+	if (HEADER_SIZE+((uint64_t) numberOfColumns)*DIRECTORY_ENTRY_SIZE > mappedSize)
+		return false;
+
+	for (uint32_t c = 0; c < numberOfColumns; ++c)	{
+		const char *entry = data+HEADER_SIZE+c*DIRECTORY_ENTRY_SIZE;
+		uint32_t parameter = readValue<uint32_t>(entry), type = readValue<uint32_t>(entry+4);
+		uint64_t offset = readValue<uint64_t>(entry+8);
+		if (parameter >= NUMBER_OF_PARAMETERS || (type != INTEGRAL_COLUMN && type != REAL_COLUMN) || (offset % 8) != 0)
+			return false;
+
+		uint64_t columnSize = ((uint64_t) numberOfActivities)*(type == REAL_COLUMN ? sizeof(double) : sizeof(uint32_t));
+		if (offset > mappedSize || columnSize > mappedSize-offset)
+			return false;
+
+		if (type == REAL_COLUMN)
+			realColumns[parameter] = (const double*) (data+offset);
+		else
+			integralColumns[parameter] = (const uint32_t*) (data+offset);
+	}
+
+	return true;
+}
+
@@ -0,0 +1,78 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef ANALYSIS_DATA_FILE_H
+#define ANALYSIS_DATA_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "BufferedWriter.h"
+#include "VisualizerScheduleStatistics.h"
+
+/*
+ * Columnar binary file with the analysis data of one instance, i.e. the parameters of the statistics figure in the schedule order.
+ * The header (magic "RCPSPCOL", version, number of activities, number of columns) is followed by the directory of the columns
+ * (parameter, type, offset) and by the columns aligned to 8 bytes. The integral parameters are stored as uint32 values,
+ * the activity freedom as doubles, the native byte order is used as in the .res files.
+ * The reader maps the file to the memory and the columns are accessed in place.
+ */
+class AnalysisDataFile {
+	public:
+
+		static void write(const std::string& file, const ParameterTable& table);
+
+		AnalysisDataFile(const std::string& file);
+		~AnalysisDataFile();
+
+		uint32_t getNumberOfActivities() const { return numberOfActivities; }
+		// NULL if the parameter is not stored in the file or it has the other type.
+		const uint32_t* getIntegralColumn(Parameter parameter) const;
+		const double* getRealColumn(Parameter parameter) const;
+
+		// The normalized parameters as computed by the analysis of the instance, e.g. the input of the group statistics.
+		InstanceResults getInstanceResults() const;
+
+	private:
+
+		AnalysisDataFile(const AnalysisDataFile&);
+		AnalysisDataFile& operator=(const AnalysisDataFile&);
+
+		bool mapFile(const std::string& file);
+		void unmapFile();
+		bool setColumnViews();
+
+		static uint64_t alignedSize(uint64_t size);
+		template <class T>
+		static void writeValue(BufferedWriter& output, const T& value);
+		template <class T>
+		static T readValue(const char *data);
+		template <class T>
+		static std::vector<double> normalizeColumn(const T *column, uint32_t numberOfValues);
+
+		void *mappedFile;
+		size_t mappedSize;
+		#ifndef __GNUC__
+		std::vector<uint64_t> fileContent;
+		#endif
+
+		uint32_t numberOfActivities;
+		const uint32_t *integralColumns[NUMBER_OF_PARAMETERS];
+		const double *realColumns[NUMBER_OF_PARAMETERS];
+};
+
+#endif
+
@@ -0,0 +1,372 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdlib>
+#include <stdexcept>
+#include "BatchManifest.h"
+#include "ContentHash.h"
+
+#define MANIFEST_HEADER "RCPSPVisualizer manifest 1"
+
+using namespace std;
+
+BatchManifest::BatchManifest(const string& file, const string& programVersion, const string& parametersHash)
+	: file(file), programVersion(programVersion), parametersHash(parametersHash), journal(NULL)	{
+	#ifdef __GNUC__
+	pthread_mutex_init(&mutex, NULL);
+	#endif
+	load();
+	// The journal is compacted at the beginning, i.e. the new records are never appended to a partially written line.
+	rewriteJournal();
+}
+
+BatchManifest::~BatchManifest()	{
+	if (journal != NULL)
+		fclose(journal);
+	#ifdef __GNUC__
+	pthread_mutex_destroy(&mutex);
+	#endif
+}
+
+bool BatchManifest::isUpToDate(const string& input, const string& inputHash, const string& output) const	{
+	if (inputHash.empty())
+		return false;
+
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	map<pair<string, string>, pair<string, string> >::const_iterator it = outputs.find(pair<string, string>(input, output));
+	bool recorded = (it != outputs.end() && it->second.first == getIdentity(inputHash));
+	string outputHash = (recorded ? it->second.second : "");
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+
+	return recorded && ContentHash::hashFile(output) == outputHash;
+}
+
+bool BatchManifest::isRecorded(const string& input, const string& inputHash, const string& output) const	{
+	if (inputHash.empty())
+		return false;
+
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	map<pair<string, string>, pair<string, string> >::const_iterator it = outputs.find(pair<string, string>(input, output));
+	bool recorded = (it != outputs.end() && it->second.first == getIdentity(inputHash));
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+
+	return recorded;
+}
+
+bool BatchManifest::getResults(const string& input, const string& inputHash, InstanceResults& instanceResults) const	{
+	if (inputHash.empty())
+		return false;
+
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	map<string, pair<string, InstanceResults> >::const_iterator it = results.find(input);
+	bool recorded = (it != results.end() && it->second.first == getIdentity(inputHash));
+	if (recorded)
+		instanceResults = it->second.second;
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+
+	return recorded;
+}
+
+void BatchManifest::addOutput(const string& input, const string& inputHash, const string& output)	{
+	string outputHash = ContentHash::hashFile(output);
+	if (inputHash.empty() || outputHash.empty())
+		return;
+
+	vector<string> fields;
+	fields.push_back("O");
+	fields.push_back(input);
+	fields.push_back(programVersion);
+	fields.push_back(parametersHash);
+	fields.push_back(inputHash);
+	fields.push_back(output);
+	fields.push_back(outputHash);
+
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	outputs[pair<string, string>(input, output)] = pair<string, string>(getIdentity(inputHash), outputHash);
+	appendRecord("O\t"+input+"\t"+output, fields);
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+}
+
+void BatchManifest::addResults(const string& input, const string& inputHash, const InstanceResults& instanceResults)	{
+	if (inputHash.empty())
+		return;
+
+	vector<string> fields;
+	fields.push_back("R");
+	fields.push_back(input);
+	fields.push_back(programVersion);
+	fields.push_back(parametersHash);
+	fields.push_back(inputHash);
+	fields.push_back(toString(instanceResults.numberOfColumns));
+	fields.push_back(toString(instanceResults.results.size()));
+	for (map<Parameter, ParameterResult>::const_iterator it = instanceResults.results.begin(); it != instanceResults.results.end(); ++it)	{
+		fields.push_back(toString(it->first));
+		fields.push_back(it->second.description);
+		fields.push_back(formatValues(it->second.parameterValues));
+	}
+
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	results[input] = pair<string, InstanceResults>(getIdentity(inputHash), instanceResults);
+	appendRecord("R\t"+input, fields);
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+}
+
+void BatchManifest::compact()	{
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	try {
+		rewriteJournal();
+	} catch (...)	{
+		#ifdef __GNUC__
+		pthread_mutex_unlock(&mutex);
+		#endif
+		throw;
+	}
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+}
+
+void BatchManifest::load()	{
+	FILE *input = fopen(file.c_str(), "rb");
+	if (input == NULL)
+		return;
+
+	string content;
+	char buffer[65536];
+	size_t size;
+	while ((size = fread(buffer, 1, sizeof(buffer), input)) > 0)
+		content.append(buffer, size);
+	fclose(input);
+
+	size_t lineStart = 0, lineNumber = 0;
+	while (lineStart < content.size())	{
+		size_t lineEnd = content.find('\n', lineStart);
+		if (lineEnd == string::npos)
+			break;
+
+		string line = content.substr(lineStart, lineEnd-lineStart);
+		if (lineNumber++ == 0)	{
+			// The records of the other manifest versions are not read.
+			if (line != MANIFEST_HEADER)
+				return;
+		} else {
+			parseRecord(line);
+		}
+		lineStart = lineEnd+1;
+	}
+}
+
+bool BatchManifest::parseRecord(const string& line)	{
+	/* VERIFY THE CHECKSUM */
+	size_t checksumStart = line.rfind("\t#");
+	if (checksumStart == string::npos)
+		return false;
+
+	ContentHash checksum;
+	checksum.update(line.data(), checksumStart);
+	if (line.compare(checksumStart+2, string::npos, checksum.getHexValue()) != 0)
+		return false;
+
+	vector<string> fields;
+	size_t fieldStart = 0;
+	while (fieldStart <= checksumStart)	{
+		size_t fieldEnd = line.find('\t', fieldStart);
+		fields.push_back(unescape(line.substr(fieldStart, fieldEnd-fieldStart)));
+		fieldStart = fieldEnd+1;
+	}
+
+	if (fields.size() < 5)
+		return false;
+
+	/* READ THE RECORD */
+	string identity = fields[2]+"\t"+fields[3]+"\t"+fields[4];
+	if (fields[0] == "O" && fields.size() == 7)	{
+		outputs[pair<string, string>(fields[1], fields[5])] = pair<string, string>(identity, fields[6]);
+		records["O\t"+fields[1]+"\t"+fields[5]] = line;
+		return true;
+	} else if (fields[0] == "R" && fields.size() >= 7)	{
+		InstanceResults instanceResults;
+		instanceResults.numberOfColumns = strtoul(fields[5].c_str(), NULL, 10);
+		uint32_t numberOfParameters = strtoul(fields[6].c_str(), NULL, 10);
+		if (fields.size() != 7+3*numberOfParameters)
+			return false;
+
+		for (uint32_t p = 0; p < numberOfParameters; ++p)	{
+			Parameter parameter = (Parameter) strtoul(fields[7+3*p].c_str(), NULL, 10);
+			ParameterResult& result = instanceResults.results[parameter];
+			result.description = fields[8+3*p];
+
+			const char *value = fields[9+3*p].c_str();
+			char *end = NULL;
+			while (*value != '\0')	{
+				result.parameterValues.push_back(strtod(value, &end));
+				if (end == value)
+					return false;
+				value = (*end == ' ' ? end+1 : end);
+			}
+		}
+
+		results[fields[1]] = pair<string, InstanceResults>(identity, instanceResults);
+		records["R\t"+fields[1]] = line;
+		return true;
+	}
+
+	return false;
+}
+
+void BatchManifest::appendRecord(const string& key, const vector<string>& fields)	{
+	string line = formatRecord(fields);
+	records[key] = line;
+	if (journal != NULL)	{
+		// The record is flushed immediately, it survives the interruption of the program.
+		fputs(line.c_str(), journal);
+		fputc('\n', journal);
+		fflush(journal);
+	}
+}
+
+void BatchManifest::rewriteJournal()	{
+	if (journal != NULL)	{
+		fclose(journal);
+		journal = NULL;
+	}
+
+	string temporaryFile = file+".tmp";
+	FILE *output = fopen(temporaryFile.c_str(), "wb");
+	if (output == NULL)
+		throw runtime_error("BatchManifest::rewriteJournal: Cannot write the manifest \""+temporaryFile+"\"!");
+
+	fputs(MANIFEST_HEADER "\n", output);
+	for (map<string, string>::const_iterator it = records.begin(); it != records.end(); ++it)	{
+		fputs(it->second.c_str(), output);
+		fputc('\n', output);
+	}
+
+	bool writeError = (ferror(output) != 0);
+	if (fclose(output) != 0 || writeError || rename(temporaryFile.c_str(), file.c_str()) != 0)	{
+		remove(temporaryFile.c_str());
+		throw runtime_error("BatchManifest::rewriteJournal: Cannot write the manifest \""+file+"\"!");
+	}
+
+	journal = fopen(file.c_str(), "ab");
+	if (journal == NULL)
+		throw runtime_error("BatchManifest::rewriteJournal: Cannot open the manifest \""+file+"\"!");
+}
+
+string BatchManifest::getIdentity(const string& inputHash) const	{
+	return programVersion+"\t"+parametersHash+"\t"+inputHash;
+}
+
+string BatchManifest::formatRecord(const vector<string>& fields)	{
+	string line;
+	for (vector<string>::const_iterator it = fields.begin(); it != fields.end(); ++it)
+		line += escape(*it)+"\t";
+
+	ContentHash checksum;
+	checksum.update(line.data(), line.size()-1);
+	line += "#"+checksum.getHexValue();
+	return line;
+}
+
+string BatchManifest::escape(const string& field)	{
+	string escaped;
+	for (string::const_iterator it = field.begin(); it != field.end(); ++it)	{
+		switch (*it)	{
+			case '\\':
+				escaped += "\\\\";
+				break;
+			case '\t':
+				escaped += "\\t";
+				break;
+			case '\n':
+				escaped += "\\n";
+				break;
+			case '\r':
+				escaped += "\\r";
+				break;
+			default:
+				escaped += *it;
+		}
+	}
+	return escaped;
+}
+
+string BatchManifest::unescape(const string& field)	{
+	string unescaped;
+	for (string::const_iterator it = field.begin(); it != field.end(); ++it)	{
+		if (*it == '\\' && it+1 != field.end())	{
+			++it;
+			switch (*it)	{
+				case 't':
+					unescaped += '\t';
+					break;
+				case 'n':
+					unescaped += '\n';
+					break;
+				case 'r':
+					unescaped += '\r';
+					break;
+				default:
+					unescaped += *it;
+			}
+		} else {
+			unescaped += *it;
+		}
+	}
+	return unescaped;
+}
+
+string BatchManifest::toString(uint32_t value)	{
+	char buffer[16];
+	snprintf(buffer, sizeof(buffer), "%u", value);
+	return buffer;
+}
+
+string BatchManifest::formatValues(const vector<double>& values)	{
+	// 17 significant digits, i.e. the values are read back exactly and the group statistics do not change.
+	string formatted;
+	char buffer[32];
+	for (vector<double>::const_iterator it = values.begin(); it != values.end(); ++it)	{
+		snprintf(buffer, sizeof(buffer), "%.17g", *it);
+		if (it != values.begin())
+			formatted += ' ';
+		formatted += buffer;
+	}
+	return formatted;
+}
+
@@ -0,0 +1,88 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BATCH_MANIFEST_H
+#define BATCH_MANIFEST_H
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include "VisualizerScheduleStatistics.h"
+
+#ifdef __GNUC__
+#include <pthread.h>
+#endif
+
+/*
+ * Manifest of the incremental batch processing. The outputs and the analysis results of the input files are recorded
+ * together with the hash of the input, the program version, and the hash of the parameters. The records are appended
+ * to the journal file as soon as the outputs are written, i.e. the interrupted batch is resumed by the next run.
+ * Each record is one line with a checksum, the partially written records are ignored.
+ */
+class BatchManifest {
+	public:
+
+		BatchManifest(const std::string& file, const std::string& programVersion, const std::string& parametersHash);
+		~BatchManifest();
+
+		// The output is up to date if it was generated from the same input by the same program and parameters and it was not modified since.
+		bool isUpToDate(const std::string& input, const std::string& inputHash, const std::string& output) const;
+		// The output was generated from the same input by the same program and parameters, regardless of its current content.
+		bool isRecorded(const std::string& input, const std::string& inputHash, const std::string& output) const;
+		bool getResults(const std::string& input, const std::string& inputHash, InstanceResults& results) const;
+
+		void addOutput(const std::string& input, const std::string& inputHash, const std::string& output);
+		void addResults(const std::string& input, const std::string& inputHash, const InstanceResults& results);
+
+		// The journal is rewritten with the latest records only.
+		void compact();
+
+	private:
+
+		BatchManifest(const BatchManifest&);
+		BatchManifest& operator=(const BatchManifest&);
+
+		void load();
+		bool parseRecord(const std::string& line);
+		void appendRecord(const std::string& key, const std::vector<std::string>& fields);
+		void rewriteJournal();
+		std::string getIdentity(const std::string& inputHash) const;
+
+		static std::string formatRecord(const std::vector<std::string>& fields);
+		static std::string escape(const std::string& field);
+		static std::string unescape(const std::string& field);
+		static std::string toString(uint32_t value);
+		static std::string formatValues(const std::vector<double>& values);
+
+		std::string file, programVersion, parametersHash;
+		FILE *journal;
+
+		// Key of the record ("O" input output ~ written output, "R" input ~ analysis results) and its formatted line.
+		std::map<std::string, std::string> records;
+		// (input, output) -> (identity, hash of the output)
+		std::map<std::pair<std::string, std::string>, std::pair<std::string, std::string> > outputs;
+		// input -> (identity, analysis results)
+		std::map<std::string, std::pair<std::string, InstanceResults> > results;
+
+		#ifdef __GNUC__
+		mutable pthread_mutex_t mutex;
+		#endif
+};
+
+#endif
+
@@ -14,21 +14,22 @@
 	You should have received a copy of the GNU General Public License
 	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
 */
+#include <algorithm>
 #include <iostream>
-#include <set>
 #include <stdexcept>
 #include "BlocksPlacerGLPK.h"
+#include "BlocksPlacerHeuristic.h"
 #include "DefaultParameters.h"
 
 using namespace std;
 
-BlocksPlacerGLPK::BlocksPlacerGLPK(uint32_t numberOfActivities, uint32_t resourceId, uint32_t *startTimesById, uint32_t* activitiesDuration,
-		uint32_t *capacityOfResources, uint32_t **requiredCap)	{
+BlocksPlacerGLPK::BlocksPlacerGLPK(uint32_t numberOfActivities, uint32_t numberOfResources, uint32_t resourceId, const uint32_t *startTimesById,
+		const uint32_t* activitiesDuration, const uint32_t *capacityOfResources, const uint32_t *requiredCap) : incumbentSubmitted(false)	{
 
 	/* FIND BLOCKS IN THE PROJECT */
 	uint32_t resourceCapacity = capacityOfResources[resourceId];
 	for (uint32_t id = 0; id < numberOfActivities; ++id)	{
-		if (activitiesDuration[id] > 0 && requiredCap[id][resourceId] > 0)
+		if (activitiesDuration[id] > 0 && requiredCap[id*numberOfResources+resourceId] > 0)
 			activities.push_back(id);
 	}
 
@@ -47,80 +48,106 @@ BlocksPlacerGLPK::BlocksPlacerGLPK(uint32_t numberOfActivities, uint32_t resourc
 	settings.tm_lim = ConfigureILPSolver::timeLimit;
 	settings.mip_gap = ConfigureILPSolver::mipGap;
 
-	/* ADD EQUATIONS */
-	uint32_t line = 1;
-	set<uint64_t> equationsAdded;
-	glp_add_cols(mip, activities.size());
-	uint32_t binaryVariableIndex = activities.size()+1;
-
-	for (uint32_t i = 0; i < activities.size(); ++i)	{
-
-		uint32_t activityIdI = activities[i];
-		uint32_t startI = startTimesById[activityIdI];
-		uint32_t durationI = activitiesDuration[activityIdI];
-		uint32_t requirementI = requiredCap[activityIdI][resourceId];
-
-		for (uint32_t j = 0; j < activities.size(); ++j)	{
-
-			uint32_t activityIdJ = activities[j];
-			uint32_t startJ = startTimesById[activityIdJ];
-			uint32_t durationJ = activitiesDuration[activityIdJ];
-			uint32_t requirementJ = requiredCap[activityIdJ][resourceId];
-
-			if (startI+durationI > startJ && startJ+durationJ > startI && i != j)	{
-				uint64_t key = (activityIdI < activityIdJ ? activityIdI : activityIdJ);
-				key <<= 32;
-				key |= (activityIdI < activityIdJ ? activityIdJ : activityIdI);
-
-				if (equationsAdded.find(key) != equationsAdded.end())
-					continue;
-
-				int32_t indices[4];
-				double values[4];
-
-				glp_add_rows(mip, 2);
-				glp_add_cols(mip, 1);
-
-				// y_i - y_x + UB*b_{i,x} >= r_{x,k}
-				indices[1] = i+1;
-				indices[2] = j+1;
-				indices[3] = binaryVariableIndex;
-
-				values[1] = 1;
-				values[2] = -1;
-				values[3] = resourceCapacity;
-
-				glp_set_mat_row(mip, line, 3, indices, values);
-				glp_set_row_bnds(mip, line++, GLP_LO, requirementJ, 0);
-
-				// y_x - y_i - UB*b_{i,x} >= r_{i,k} - UB
-				indices[1] = j+1;
-				indices[2] = i+1;
-				indices[3] = binaryVariableIndex;
-
-				values[1] = 1;
-				values[2] = -1;
-				values[3] = -((int32_t) resourceCapacity);
+	/* HEURISTIC PLACEMENT */
+	vector<uint32_t> heuristicOffsets;
+	try {
+		BlocksPlacerHeuristic heuristic(numberOfActivities, numberOfResources, resourceId, startTimesById, activitiesDuration, capacityOfResources, requiredCap);
+		heuristicSolution = heuristic.solve();
+		// The solution is sorted by the activity identifications, i.e. in the order of the integer variables.
+		for (uint32_t i = 0; i < heuristicSolution.size(); ++i)
+			heuristicOffsets.push_back(heuristicSolution[i].second);
+	} catch (exception& e)	{
+		heuristicSolution.clear();
+	}
 
-				glp_set_mat_row(mip, line, 3, indices, values);
-				glp_set_row_bnds(mip, line++, GLP_LO, ((int32_t) requirementI)-((int32_t) resourceCapacity), 0);
-				
-				equationsAdded.insert(key);
-				++binaryVariableIndex;
+	/* FIND OVERLAPPING BLOCKS */
+	// Blocks are swept in the order of start times, the active blocks are those which have not finished yet.
+	vector<pair<uint32_t, uint32_t> > sweepOrder;
+	for (uint32_t i = 0; i < activities.size(); ++i)
+		sweepOrder.push_back(pair<uint32_t, uint32_t>(startTimesById[activities[i]], i));
+	sort(sweepOrder.begin(), sweepOrder.end());
+
+	vector<uint32_t> activeBlocks;
+	vector<pair<uint32_t, uint32_t> > overlappingPairs;
+	for (vector<pair<uint32_t, uint32_t> >::const_iterator it = sweepOrder.begin(); it != sweepOrder.end(); ++it)	{
+		uint32_t start = it->first, i = it->second;
+		vector<uint32_t>::iterator activeIt = activeBlocks.begin();
+		while (activeIt != activeBlocks.end())	{
+			uint32_t j = *activeIt;
+			if (startTimesById[activities[j]]+activitiesDuration[activities[j]] <= start)	{
+				*activeIt = activeBlocks.back();
+				activeBlocks.pop_back();
+			} else {
+				overlappingPairs.push_back(pair<uint32_t, uint32_t>(min(i, j), max(i, j)));
+				++activeIt;
 			}
 		}
+		activeBlocks.push_back(i);
+	}
+	// The binary variables are ordered by the pairs of the block indices.
+	sort(overlappingPairs.begin(), overlappingPairs.end());
+
+	/* ADD EQUATIONS */
+	uint32_t numberOfPairs = overlappingPairs.size();
+	if (activities.size()+numberOfPairs > 0)
+		glp_add_cols(mip, activities.size()+numberOfPairs);
+	if (numberOfPairs > 0)
+		glp_add_rows(mip, 2*numberOfPairs);
+
+	// Coefficients of the constraint matrix indexed from 1, i.e. the GLPK convention.
+	vector<int> rowIndices(1, 0), columnIndices(1, 0);
+	vector<double> values(1, 0.0);
+	rowIndices.reserve(6*numberOfPairs+1);
+	columnIndices.reserve(6*numberOfPairs+1);
+	values.reserve(6*numberOfPairs+1);
+
+	for (uint32_t p = 0; p < numberOfPairs; ++p)	{
+
+		uint32_t i = overlappingPairs[p].first, j = overlappingPairs[p].second;
+		uint32_t requirementI = requiredCap[activities[i]*numberOfResources+resourceId];
+		uint32_t requirementJ = requiredCap[activities[j]*numberOfResources+resourceId];
+		int32_t binaryVariableIndex = activities.size()+p+1;
+		int32_t line = 2*p+1;
+
+		// y_i - y_x + UB*b_{i,x} >= r_{x,k}
+		rowIndices.push_back(line); columnIndices.push_back(i+1); values.push_back(1);
+		rowIndices.push_back(line); columnIndices.push_back(j+1); values.push_back(-1);
+		rowIndices.push_back(line); columnIndices.push_back(binaryVariableIndex); values.push_back(resourceCapacity);
+		glp_set_row_bnds(mip, line, GLP_LO, requirementJ, 0);
+
+		// y_x - y_i - UB*b_{i,x} >= r_{i,k} - UB
+		++line;
+		rowIndices.push_back(line); columnIndices.push_back(j+1); values.push_back(1);
+		rowIndices.push_back(line); columnIndices.push_back(i+1); values.push_back(-1);
+		rowIndices.push_back(line); columnIndices.push_back(binaryVariableIndex); values.push_back(-((int32_t) resourceCapacity));
+		glp_set_row_bnds(mip, line, GLP_LO, ((int32_t) requirementI)-((int32_t) resourceCapacity), 0);
+
+		if (!heuristicOffsets.empty())	{
+			// b_{i,x} = 1 iff the block x is placed above the block i.
+			incumbent.push_back(heuristicOffsets[j] >= heuristicOffsets[i]+requirementI ? 1 : 0);
+		}
 	}
 
+	if (numberOfPairs > 0)
+		glp_load_matrix(mip, rowIndices.size()-1, &rowIndices[0], &columnIndices[0], &values[0]);
+
 	/* SET VARIABLE TYPES AND BOUNDS */
 	for (uint32_t i = 0; i < activities.size(); ++i)	{
 		glp_set_col_kind(mip, i+1, GLP_IV);
-		glp_set_obj_coef(mip, i+1, requiredCap[activities[i]][resourceId]*activitiesDuration[activities[i]]);
+		glp_set_obj_coef(mip, i+1, requiredCap[activities[i]*numberOfResources+resourceId]*activitiesDuration[activities[i]]);
 		// y_i <= R_k-r_{i,k}
-		glp_set_col_bnds(mip, i+1, GLP_DB, 0, resourceCapacity-requiredCap[activities[i]][resourceId]);
+		glp_set_col_bnds(mip, i+1, GLP_DB, 0, resourceCapacity-requiredCap[activities[i]*numberOfResources+resourceId]);
 	}
 
-	for (uint32_t i = activities.size()+1; i < binaryVariableIndex; ++i)
+	for (uint32_t i = activities.size()+1; i <= activities.size()+numberOfPairs; ++i)
 		glp_set_col_kind(mip, i, GLP_BV);
+
+	if (!heuristicOffsets.empty())	{
+		incumbent.insert(incumbent.begin(), heuristicOffsets.begin(), heuristicOffsets.end());
+		incumbent.insert(incumbent.begin(), 0);
+		settings.cb_func = submitIncumbent;
+		settings.cb_info = this;
+	}
 }
 
 vector<pair<uint32_t, uint32_t> > BlocksPlacerGLPK::solve(bool verbose)	{
@@ -138,12 +165,37 @@ vector<pair<uint32_t, uint32_t> > BlocksPlacerGLPK::solve(bool verbose)	{
 		clog<<"Number of equations: "<<numberOfEquations<<endl;
 	}
 
+	if (activities.empty())
+		return solution;
+
 	/* SOLVE ILP */
-	int retCode = glp_intopt(mip,&settings);
-	if (retCode != 0 && retCode != GLP_ETMLIM && retCode != GLP_EMIPGAP)	{
+	int retCode;
+	if (!heuristicSolution.empty())	{
+		// The incumbent is given in the variables of the original problem, i.e. the presolver cannot be used
+		// and the LP relaxation has to be solved before the branch-and-cut.
+		glp_smcp simplexSettings;
+		glp_init_smcp(&simplexSettings);
+		simplexSettings.msg_lev = settings.msg_lev;
+		simplexSettings.tm_lim = settings.tm_lim;
+		settings.presolve = GLP_OFF;
+		retCode = glp_simplex(mip, &simplexSettings);
+		if (retCode == 0 && glp_get_status(mip) == GLP_OPT)
+			retCode = glp_intopt(mip, &settings);
+		else
+			retCode = GLP_EROOT;
+	} else {
+		retCode = glp_intopt(mip, &settings);
+	}
+
+	int status = glp_mip_status(mip);
+	if (!heuristicSolution.empty() && ((retCode != 0 && retCode != GLP_ETMLIM && retCode != GLP_EMIPGAP) || (status != GLP_OPT && status != GLP_FEAS)))	{
+		// The solver did not find any better placement in the time limit.
+		if (verbose)
+			clog<<"The heuristic placement was used!"<<endl;
+		solution = heuristicSolution;
+	} else if (retCode != 0 && retCode != GLP_ETMLIM && retCode != GLP_EMIPGAP)	{
 		throw runtime_error("GLPKSolver::solve: "+getGlpkError(retCode));
 	} else {
-		int status = glp_mip_status(mip);
 		if (status == GLP_OPT || status == GLP_FEAS)	{
 			int criterion = glp_mip_obj_val(mip);
 			for (uint32_t i = 0; i < activities.size(); ++i)	{
@@ -182,6 +234,14 @@ vector<pair<uint32_t, uint32_t> > BlocksPlacerGLPK::solve(bool verbose)	{
 	return solution;
 }
 
+void BlocksPlacerGLPK::submitIncumbent(glp_tree *tree, void *placer)	{
+	BlocksPlacerGLPK *blocksPlacer = (BlocksPlacerGLPK*) placer;
+	if (glp_ios_reason(tree) == GLP_IHEUR && !blocksPlacer->incumbentSubmitted)	{
+		glp_ios_heur_sol(tree, &blocksPlacer->incumbent[0]);
+		blocksPlacer->incumbentSubmitted = true;
+	}
+}
+
 string BlocksPlacerGLPK::getGlpkError(int code) const	{
 	string errorMessage;
 	switch (code)	{
@@ -26,17 +26,25 @@
 
 class BlocksPlacerGLPK {
 	public:
-		BlocksPlacerGLPK(uint32_t numberOfActivities, uint32_t resourceId,  uint32_t *startTimesById, uint32_t* activitiesDuration,
-				uint32_t *capacityOfResources, uint32_t **requiredCap);
+		BlocksPlacerGLPK(uint32_t numberOfActivities, uint32_t numberOfResources, uint32_t resourceId, const uint32_t *startTimesById,
+				const uint32_t* activitiesDuration, const uint32_t *capacityOfResources, const uint32_t *requiredCap);
 		std::vector<std::pair<uint32_t, uint32_t> > solve(bool verbose = false);
 		~BlocksPlacerGLPK();
 	private:
 
 		std::string getGlpkError(int code) const;
+		// Branch-and-cut callback, the heuristic placement is provided as the first incumbent.
+		static void submitIncumbent(glp_tree *tree, void *placer);
 
 		glp_prob *mip;
 		glp_iocp settings;
 		std::vector<uint32_t> activities;
+
+		// Placement found by BlocksPlacerHeuristic, it is empty if the heuristic failed.
+		std::vector<std::pair<uint32_t, uint32_t> > heuristicSolution;
+		// Values of the columns (indexed from 1) corresponding to the heuristic placement.
+		std::vector<double> incumbent;
+		bool incumbentSubmitted;
 };
 
 #endif
@@ -0,0 +1,271 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "BlocksPlacerHeuristic.h"
+
+#ifdef __GNUC__
+#include <sys/time.h>
+#endif
+
+using namespace std;
+
+#define UNPLACED 0xffffffffu
+// Maximal number of the improving passes over all the blocks.
+#define MAX_IMPROVING_PASSES 16
+// Maximal number of the placement attempts of the backtracking.
+#define MAX_BACKTRACKING_NODES 200000
+
+/*
+ * The orders in which the blocks are placed, the blocks are sorted by the start time.
+ */
+class BlocksOrder	{
+	public:
+		enum Rule { REQUIREMENT = 0, AREA = 1 };
+		BlocksOrder(const vector<uint32_t>& requirements, const vector<uint32_t>& durations, Rule rule)
+			: requirements(requirements), durations(durations), rule(rule) { };
+		bool operator()(uint32_t b1, uint32_t b2) const	{
+			uint64_t key1 = requirements[b1], key2 = requirements[b2];
+			if (rule == AREA)	{
+				key1 *= durations[b1];
+				key2 *= durations[b2];
+			}
+			// The stable sort keeps the start time order for the same keys.
+			return key1 > key2;
+		}
+	private:
+		const vector<uint32_t>& requirements;
+		const vector<uint32_t>& durations;
+		Rule rule;
+};
+
+BlocksPlacerHeuristic::BlocksPlacerHeuristic(uint32_t numberOfActivities, uint32_t numberOfResources, uint32_t resourceId, const uint32_t *startTimesById,
+		const uint32_t* activitiesDuration, const uint32_t *capacityOfResources, const uint32_t *requiredCap) : criterion(0)	{
+
+	resourceCapacity = capacityOfResources[resourceId];
+	for (uint32_t id = 0; id < numberOfActivities; ++id)	{
+		if (activitiesDuration[id] > 0 && requiredCap[id*numberOfResources+resourceId] > 0)	{
+			Block block;
+			block.activityId = id;
+			block.start = startTimesById[id];
+			block.finish = startTimesById[id]+activitiesDuration[id];
+			block.requirement = requiredCap[id*numberOfResources+resourceId];
+			blocks.push_back(block);
+		}
+	}
+	stable_sort(blocks.begin(), blocks.end(), compareByStart);
+
+	/* OVERLAPPING BLOCKS */
+	// The blocks are sorted by the start time, i.e. the overlapping successors of a block are found by a sweep.
+	vector<vector<uint32_t> > overlappingBlocks(blocks.size());
+	for (uint32_t i = 0; i < blocks.size(); ++i)	{
+		for (uint32_t j = i+1; j < blocks.size() && blocks[j].start < blocks[i].finish; ++j)	{
+			overlappingBlocks[i].push_back(j);
+			overlappingBlocks[j].push_back(i);
+		}
+	}
+
+	overlapsIndex.push_back(0);
+	for (uint32_t i = 0; i < blocks.size(); ++i)	{
+		overlaps.insert(overlaps.end(), overlappingBlocks[i].begin(), overlappingBlocks[i].end());
+		overlapsIndex.push_back(overlaps.size());
+	}
+}
+
+vector<pair<uint32_t, uint32_t> > BlocksPlacerHeuristic::solve(bool verbose)	{
+	#ifdef __GNUC__
+	timeval startTime, stopTime;
+	gettimeofday(&startTime, NULL);
+	#endif
+
+	vector<uint32_t> requirements, durations;
+	for (vector<Block>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)	{
+		requirements.push_back(it->requirement);
+		durations.push_back(it->finish-it->start);
+	}
+
+	vector<vector<uint32_t> > orders(3);
+	for (uint32_t b = 0; b < blocks.size(); ++b)
+		orders[0].push_back(b);
+	orders[1] = orders[2] = orders[0];
+	stable_sort(orders[1].begin(), orders[1].end(), BlocksOrder(requirements, durations, BlocksOrder::REQUIREMENT));
+	stable_sort(orders[2].begin(), orders[2].end(), BlocksOrder(requirements, durations, BlocksOrder::AREA));
+
+	/* FIRST-FIT AND IMPROVEMENT */
+	bool found = false;
+	vector<uint32_t> bestOffsets;
+	for (uint32_t o = 0; o < orders.size(); ++o)	{
+		vector<uint32_t> offsets;
+		if (placeFirstFit(orders[o], offsets))	{
+			improvePlacement(offsets);
+			uint64_t orderCriterion = computeCriterion(offsets);
+			if (!found || orderCriterion < criterion)	{
+				criterion = orderCriterion;
+				bestOffsets = offsets;
+				found = true;
+			}
+		}
+	}
+
+	if (!found)	{
+		// The blocks are placed in the start time order, the backtracking is limited by the number of tried positions.
+		vector<uint32_t> offsets(blocks.size(), UNPLACED);
+		uint32_t remainingNodes = MAX_BACKTRACKING_NODES;
+		if (placeBacktracking(offsets, remainingNodes))	{
+			improvePlacement(offsets);
+			criterion = computeCriterion(offsets);
+			bestOffsets = offsets;
+			found = true;
+		}
+	}
+
+	if (!found)
+		throw runtime_error("BlocksPlacerHeuristic::solve: No feasible placement was found!");
+
+	vector<pair<uint32_t, uint32_t> > solution;
+	for (uint32_t b = 0; b < blocks.size(); ++b)
+		solution.push_back(pair<uint32_t, uint32_t>(blocks[b].activityId, bestOffsets[b]));
+	// The same order as the solution of the ILP solver.
+	sort(solution.begin(), solution.end());
+
+	if (verbose)	{
+		clog<<string(40,'*')<<endl;
+		clog<<"Number of blocks: "<<blocks.size()<<endl;
+		clog<<"Number of overlapping pairs: "<<overlaps.size()/2<<endl;
+		clog<<"Criterion: "<<criterion<<endl;
+		#ifdef __GNUC__
+		gettimeofday(&stopTime, NULL);
+		double runTime = (stopTime.tv_sec-startTime.tv_sec)+(stopTime.tv_usec-startTime.tv_usec)/1000000.;
+		clog<<"Heuristic total time: "<<runTime<<" sec"<<endl;
+		#endif
+		clog<<string(40,'#')<<endl;
+	}
+
+	return solution;
+}
+
+bool BlocksPlacerHeuristic::placeFirstFit(const vector<uint32_t>& order, vector<uint32_t>& offsets) const	{
+	offsets.assign(blocks.size(), UNPLACED);
+	for (vector<uint32_t>::const_iterator it = order.begin(); it != order.end(); ++it)	{
+		uint32_t offset = findLowestOffset(*it, offsets);
+		if (offset == UNPLACED)	{
+			// Repair - the placed blocks are compacted down and the block is tried again.
+			improvePlacement(offsets);
+			if ((offset = findLowestOffset(*it, offsets)) == UNPLACED)
+				return false;
+		}
+		offsets[*it] = offset;
+	}
+	return true;
+}
+
+bool BlocksPlacerHeuristic::placeBacktracking(vector<uint32_t>& offsets, uint32_t& remainingNodes) const	{
+	// Depth-first search over the free positions of the blocks, the explicit stack keeps the next offset tried for each block,
+	// i.e. the depth of the search is not limited by the stack of the (worker) thread.
+	uint32_t numberOfBlocks = blocks.size();
+	vector<uint32_t> nextOffsets(numberOfBlocks, 0);
+	uint32_t b = 0;
+	while (b < numberOfBlocks)	{
+		uint32_t offset = findLowestOffset(b, offsets, nextOffsets[b]);
+		if (offset == UNPLACED)	{
+			// All the positions of the block were tried, the previous block is moved up.
+			if (b == 0)
+				return false;
+			--b;
+			nextOffsets[b] = offsets[b]+1;
+			offsets[b] = UNPLACED;
+			continue;
+		}
+
+		if (remainingNodes == 0)	{
+			offsets.assign(numberOfBlocks, UNPLACED);
+			return false;
+		}
+		--remainingNodes;
+
+		offsets[b] = offset;
+		if (++b < numberOfBlocks)
+			nextOffsets[b] = 0;
+	}
+
+	return true;
+}
+
+void BlocksPlacerHeuristic::improvePlacement(vector<uint32_t>& offsets) const	{
+	// The blocks are moved down to the lowest free gap, the heavy blocks first.
+	vector<pair<uint64_t, uint32_t> > weightedBlocks;
+	for (uint32_t b = 0; b < blocks.size(); ++b)
+		weightedBlocks.push_back(pair<uint64_t, uint32_t>(((uint64_t) blocks[b].requirement)*(blocks[b].finish-blocks[b].start), b));
+	sort(weightedBlocks.rbegin(), weightedBlocks.rend());
+
+	bool improved = true;
+	for (uint32_t pass = 0; improved && pass < MAX_IMPROVING_PASSES; ++pass)	{
+		improved = false;
+		for (vector<pair<uint64_t, uint32_t> >::const_iterator it = weightedBlocks.begin(); it != weightedBlocks.end(); ++it)	{
+			uint32_t b = it->second, currentOffset = offsets[b];
+			if (currentOffset == 0 || currentOffset == UNPLACED)
+				continue;
+
+			offsets[b] = UNPLACED;
+			uint32_t lowestOffset = findLowestOffset(b, offsets);
+			// The current offset is feasible, i.e. the lowest one cannot be greater.
+			offsets[b] = min(lowestOffset, currentOffset);
+			if (offsets[b] < currentOffset)
+				improved = true;
+		}
+	}
+}
+
+uint32_t BlocksPlacerHeuristic::findLowestOffset(uint32_t b, const vector<uint32_t>& offsets, uint32_t minOffset) const	{
+	// Occupied intervals of the placed blocks overlapping in time, the lowest free position not below minOffset is returned.
+	vector<pair<uint32_t, uint32_t> > occupied;
+	for (uint32_t i = overlapsIndex[b]; i < overlapsIndex[b+1]; ++i)	{
+		uint32_t o = overlaps[i];
+		if (offsets[o] != UNPLACED)
+			occupied.push_back(pair<uint32_t, uint32_t>(offsets[o], offsets[o]+blocks[o].requirement));
+	}
+	sort(occupied.begin(), occupied.end());
+
+	uint32_t offset = minOffset, requirement = blocks[b].requirement;
+	for (vector<pair<uint32_t, uint32_t> >::const_iterator it = occupied.begin(); it != occupied.end(); ++it)	{
+		if (offset+requirement <= it->first)
+			break;
+		offset = max(offset, it->second);
+	}
+
+	if (offset+requirement > resourceCapacity)
+		return UNPLACED;
+
+	return offset;
+}
+
+uint64_t BlocksPlacerHeuristic::computeCriterion(const vector<uint32_t>& offsets) const	{
+	uint64_t value = 0;
+	for (uint32_t b = 0; b < blocks.size(); ++b)
+		value += ((uint64_t) blocks[b].requirement)*(blocks[b].finish-blocks[b].start)*offsets[b];
+	return value;
+}
+
+bool BlocksPlacerHeuristic::compareByStart(const Block& b1, const Block& b2)	{
+	if (b1.start != b2.start)
+		return b1.start < b2.start;
+	else
+		return b1.requirement > b2.requirement;
+}
+
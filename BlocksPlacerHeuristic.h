@@ -0,0 +1,62 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef HLIDAC_PES_BLOCKS_PLACER_HEURISTIC
+#define HLIDAC_PES_BLOCKS_PLACER_HEURISTIC
+
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+/*
+ * Constructive alternative to BlocksPlacerGLPK. The blocks are placed by the first-fit rule for several orders of the blocks,
+ * if it fails, a bounded backtracking over the free positions is tried. The placements are improved by moving
+ * the blocks down to the lowest free gap and the best one is returned.
+ * The criterion is the objective of the ILP model, i.e. the sum of r_{i,k}*d_i*y_i.
+ */
+class BlocksPlacerHeuristic {
+	public:
+		BlocksPlacerHeuristic(uint32_t numberOfActivities, uint32_t numberOfResources, uint32_t resourceId, const uint32_t *startTimesById,
+				const uint32_t* activitiesDuration, const uint32_t *capacityOfResources, const uint32_t *requiredCap);
+		// It throws an exception if no feasible placement is found, the ILP solver should be used in that case.
+		std::vector<std::pair<uint32_t, uint32_t> > solve(bool verbose = false);
+		uint64_t getCriterion() const { return criterion; }
+
+	private:
+
+		struct Block	{
+			uint32_t activityId;
+			uint32_t start, finish;
+			uint32_t requirement;
+		};
+
+		bool placeFirstFit(const std::vector<uint32_t>& order, std::vector<uint32_t>& offsets) const;
+		bool placeBacktracking(std::vector<uint32_t>& offsets, uint32_t& remainingNodes) const;
+		void improvePlacement(std::vector<uint32_t>& offsets) const;
+		uint32_t findLowestOffset(uint32_t b, const std::vector<uint32_t>& offsets, uint32_t minOffset = 0) const;
+		uint64_t computeCriterion(const std::vector<uint32_t>& offsets) const;
+
+		static bool compareByStart(const Block& b1, const Block& b2);
+
+		uint32_t resourceCapacity;
+		std::vector<Block> blocks;
+		// Blocks overlapping in time, compressed sparse rows.
+		std::vector<uint32_t> overlapsIndex, overlaps;
+		uint64_t criterion;
+};
+
+#endif
+
@@ -0,0 +1,160 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "BufferedWriter.h"
+
+using namespace std;
+
+BufferedWriter::BufferedWriter(const string& file, size_t bufferSize) : fileName(file), failed(false), buffer(bufferSize < 64 ? 64 : bufferSize), position(0), flushedBytes(0)	{
+	output = fopen(file.c_str(), "wb");
+	if (output == NULL)
+		throw invalid_argument("BufferedWriter::BufferedWriter(const string&, size_t): Cannot open the output file '"+file+"'!");
+}
+
+BufferedWriter::~BufferedWriter()	{
+	if (output != NULL)	{
+		flush();
+		fclose(output);
+	}
+}
+
+BufferedWriter& BufferedWriter::operator<<(const char *str)	{
+	return write(str, strlen(str));
+}
+
+BufferedWriter& BufferedWriter::operator<<(const string& str)	{
+	return write(str.data(), str.size());
+}
+
+BufferedWriter& BufferedWriter::operator<<(char c)	{
+	if (position == buffer.size())
+		flush();
+	buffer[position++] = c;
+	return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(int32_t value)	{
+	return *this<<((int64_t) value);
+}
+
+BufferedWriter& BufferedWriter::operator<<(uint32_t value)	{
+	writeUnsigned(value);
+	return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(int64_t value)	{
+	if (value < 0)	{
+		*this<<'-';
+		writeUnsigned(-((uint64_t) value));
+	} else {
+		writeUnsigned(value);
+	}
+	return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(uint64_t value)	{
+	writeUnsigned(value);
+	return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(double value)	{
+	// Fast paths for integers and halves, the typical coordinates of the figures.
+	double magnitude = fabs(value);
+	if (magnitude < 1e6 && value == floor(value))	{
+		return *this<<((int64_t) value);
+	} else if (magnitude < 1e5 && 2*value == floor(2*value))	{
+		if (value < 0)
+			*this<<'-';
+		writeUnsigned((uint64_t) magnitude);
+		return write(".5", 2);
+	} else {
+		char number[32];
+		int length = snprintf(number, sizeof(number), "%g", value);
+		return write(number, length);
+	}
+}
+
+BufferedWriter& BufferedWriter::writeFixed(double value, uint32_t precision)	{
+	// The C library rounds the exact binary value, i.e. the same digits as the fixed notation of the streams.
+	char number[384];
+	int length = snprintf(number, sizeof(number), "%.*f", (int) precision, value);
+	if (length < 0 || length >= (int) sizeof(number))
+		throw runtime_error("BufferedWriter::writeFixed: Cannot format the number!");
+	return write(number, length);
+}
+
+BufferedWriter& BufferedWriter::write(const char *data, size_t length)	{
+	while (length > 0)	{
+		if (position == buffer.size())
+			flush();
+		size_t chunk = min(length, buffer.size()-position);
+		memcpy(&buffer[position], data, chunk);
+		position += chunk;
+		data += chunk;
+		length -= chunk;
+	}
+	return *this;
+}
+
+void BufferedWriter::overwrite(uint64_t filePosition, const char *data, size_t length)	{
+	if (filePosition+length > getPosition())
+		throw invalid_argument("BufferedWriter::overwrite: The replaced bytes were not written yet!");
+
+	flush();
+	if (output == NULL || fseek(output, filePosition, SEEK_SET) != 0 || fwrite(data, 1, length, output) != length || fseek(output, 0, SEEK_END) != 0)
+		failed = true;
+}
+
+void BufferedWriter::close()	{
+	if (output != NULL)	{
+		flush();
+		if (fclose(output) != 0)
+			failed = true;
+		output = NULL;
+	}
+
+	if (failed)
+		throw runtime_error("BufferedWriter::close(): Cannot write the output file '"+fileName+"'!");
+}
+
+void BufferedWriter::writeUnsigned(uint64_t value)	{
+	char digits[20];
+	uint32_t length = 0;
+	do {
+		digits[length++] = '0'+(value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	if (buffer.size()-position < length)
+		flush();
+	while (length > 0)
+		buffer[position++] = digits[--length];
+}
+
+void BufferedWriter::flush()	{
+	if (position > 0 && output != NULL)	{
+		if (fwrite(&buffer[0], 1, position, output) != position)
+			failed = true;
+	}
+	flushedBytes += position;
+	position = 0;
+}
@@ -0,0 +1,74 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/*
+ * Output file with a large write buffer. The generators stream the documents directly to the file,
+ * i.e. the peak memory does not depend on the size of the document. The numbers are formatted
+ * without iostreams, doubles are printed as by the default ostream format (%g).
+ */
+class BufferedWriter {
+	public:
+
+		BufferedWriter(const std::string& file, size_t bufferSize = 1 << 20);
+		~BufferedWriter();
+
+		BufferedWriter& operator<<(const char *str);
+		BufferedWriter& operator<<(const std::string& str);
+		BufferedWriter& operator<<(char c);
+		BufferedWriter& operator<<(int32_t value);
+		BufferedWriter& operator<<(uint32_t value);
+		BufferedWriter& operator<<(int64_t value);
+		BufferedWriter& operator<<(uint64_t value);
+		BufferedWriter& operator<<(double value);
+
+		// Fixed-point notation with the given number of decimal places.
+		BufferedWriter& writeFixed(double value, uint32_t precision);
+		BufferedWriter& write(const char *data, size_t length);
+
+		// Number of bytes written since the file was opened.
+		uint64_t getPosition() const { return flushedBytes+position; }
+		// It replaces the already written bytes at the given position, e.g. a reserved header field.
+		void overwrite(uint64_t filePosition, const char *data, size_t length);
+
+		// It flushes the buffer and closes the file, the write errors are reported by an exception.
+		void close();
+
+	private:
+
+		BufferedWriter(const BufferedWriter&);
+		BufferedWriter& operator=(const BufferedWriter&);
+
+		void writeUnsigned(uint64_t value);
+		void flush();
+
+		std::string fileName;
+		FILE *output;
+		bool failed;
+		std::vector<char> buffer;
+		size_t position;
+		uint64_t flushedBytes;
+};
+
+#endif
+
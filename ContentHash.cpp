@@ -0,0 +1,58 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include "ContentHash.h"
+
+using namespace std;
+
+ContentHash::ContentHash()	{
+	value = (((uint64_t) 0xcbf29ce4) << 32) | 0x84222325;
+}
+
+void ContentHash::update(const char *data, size_t length)	{
+	const uint64_t prime = (((uint64_t) 0x00000100) << 32) | 0x000001b3;
+	for (size_t i = 0; i < length; ++i)	{
+		value ^= (unsigned char) data[i];
+		value *= prime;
+	}
+}
+
+string ContentHash::getHexValue() const	{
+	static const char digits[] = "0123456789abcdef";
+	uint64_t hash = value;
+	string hexValue(16, '0');
+	for (int32_t i = 15; i >= 0; --i, hash >>= 4)
+		hexValue[i] = digits[hash & 0xf];
+	return hexValue;
+}
+
+string ContentHash::hashFile(const string& file)	{
+	FILE *input = fopen(file.c_str(), "rb");
+	if (input == NULL)
+		return "";
+
+	ContentHash hash;
+	char buffer[65536];
+	size_t size;
+	while ((size = fread(buffer, 1, sizeof(buffer), input)) > 0)
+		hash.update(buffer, size);
+
+	bool readError = (ferror(input) != 0);
+	fclose(input);
+	return (readError ? "" : hash.getHexValue());
+}
+
@@ -0,0 +1,48 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <string>
+#include <stdint.h>
+
+/*
+ * 64-bit FNV-1a hash of the content, the data can be added by parts.
+ * It identifies the cached results, i.e. it is not intended for the cryptographic purposes.
+ */
+class ContentHash {
+	public:
+
+		ContentHash();
+
+		void update(const char *data, size_t length);
+		void update(const std::string& data) { update(data.data(), data.size()); }
+
+		uint64_t getValue() const { return value; }
+		// 16 hexadecimal digits.
+		std::string getHexValue() const;
+
+		// The hexadecimal hash of the file content, the empty string is returned if the file cannot be read.
+		static std::string hashFile(const std::string& file);
+
+	private:
+
+		uint64_t value;
+};
+
+#endif
+
@@ -16,6 +16,7 @@
 */
 #include <stdint.h>
 #include <glpk.h>
+#include "DefaultParameters.h"
 
 namespace ConfigureGraph {
 	const char* standardNodeColor = "\"#ccccff\"";
@@ -32,6 +33,8 @@ namespace ConfigureResourceUtilization	{
 	double axisElongationY = 0.7;
 	double textDist = 10;
 	double ticsLength = 0.1;
+	uint32_t tileWidth = 0; // The longer schedules are split into the tiles (independent documents) of this time span, 0 ~ no tiles.
+	uint32_t maxNumberOfTics = 120; // If the tiles are enabled, the spacing of the time tics is increased (1, 2, 5, 10, 20, ...) to keep this limit per tile.
 }
 
 namespace ConfigureILPSolver    {
@@ -42,8 +45,23 @@ namespace ConfigureILPSolver    {
 	double mipGap = 0.0;
 }
 
+namespace ConfigureBlocksPlacement	{
+	BlocksPlacerType placer = ILP_PLACER; // ILP_PLACER ~ GLPK, HEURISTIC_PLACER ~ first-fit with the ILP fallback
+	const char* cacheDirectory = ""; // Directory of the cached ILP placements, the empty string disables the cache.
+}
+
+namespace ConfigureOutput	{
+	FigureFormat figureFormat = TIKZ_FORMAT; // TIKZ_FORMAT ~ Latex sources, SVG_FORMAT and PDF_FORMAT are written directly
+}
+
+namespace ConfigureBatch	{
+	uint32_t numberOfThreads = 0; // 0 ~ number of cores
+}
+
 namespace ConfigureScheduleAnalysis     {
 	uint32_t boxSize = 2;
 	uint32_t averageWindow = 5;
+	uint32_t maxNumberOfColumns = 200; // The longer rows are binned, each box shows the mean, minimum, and maximum of its bin.
+	uint32_t maxNumberOfLabeledColumns = 150; // The values are not written into the boxes of the longer rows.
 }
 
@@ -34,6 +34,8 @@ namespace ConfigureResourceUtilization	{
 	extern double axisElongationY;
 	extern double textDist;
 	extern double ticsLength;
+	extern uint32_t tileWidth;
+	extern uint32_t maxNumberOfTics;
 }
 
 namespace ConfigureILPSolver	{
@@ -44,9 +46,33 @@ namespace ConfigureILPSolver	{
 	extern double mipGap;
 }
 
+enum FigureFormat	{
+	TIKZ_FORMAT = 0, SVG_FORMAT = 1, PDF_FORMAT = 2
+};
+
+namespace ConfigureOutput	{
+	extern FigureFormat figureFormat;
+}
+
+// The heuristic placer falls back to the ILP solver if it does not find a feasible placement.
+enum BlocksPlacerType	{
+	ILP_PLACER = 0, HEURISTIC_PLACER = 1
+};
+
+namespace ConfigureBlocksPlacement	{
+	extern BlocksPlacerType placer;
+	extern const char* cacheDirectory;
+}
+
+namespace ConfigureBatch	{
+	extern uint32_t numberOfThreads;
+}
+
 namespace ConfigureScheduleAnalysis	{
 	extern uint32_t boxSize;
 	extern uint32_t averageWindow;
+	extern uint32_t maxNumberOfColumns;
+	extern uint32_t maxNumberOfLabeledColumns;
 }
 
 #endif
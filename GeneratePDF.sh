@@ -29,12 +29,25 @@ mkdir -p GroupAnalysisPdf/
 mkdir -p CompleteAnalysisTex/
 mkdir -p CompleteAnalysisPdf/
 
+# The figures written directly by RCPSPVisualizer --format svg.
+for svgFile in *.svg
+do
+	[ -e "$svgFile" ] || break
+	mkdir -p Svg/
+	mv "$svgFile" Svg/
+done
+
 mv *_GH.dot GraphDot/ 2> /dev/null
 mv *_GH.pdf GraphPdf/ 2> /dev/null
 mv *_RU.tex ResourceUtilizationTex/ 2> /dev/null
 mv *_RU.pdf ResourceUtilizationPdf/ 2> /dev/null
 mv *_RU_ILP.tex ResourceUtilizationILPTex/ 2> /dev/null
 mv *_RU_ILP.pdf ResourceUtilizationILPPdf/ 2> /dev/null
+# The tiles of the long schedules.
+mv *_RU_ILP_[0-9]*.tex ResourceUtilizationILPTex/ 2> /dev/null
+mv *_RU_ILP_[0-9]*.pdf ResourceUtilizationILPPdf/ 2> /dev/null
+mv *_RU_[0-9]*.tex ResourceUtilizationTex/ 2> /dev/null
+mv *_RU_[0-9]*.pdf ResourceUtilizationPdf/ 2> /dev/null
 mv *_ST.tex ScheduleAnalysisTex/ 2> /dev/null
 mv *_ST.pdf ScheduleAnalysisPdf/ 2> /dev/null
 mv stat_*.tex GroupAnalysisTex/ 2> /dev/null
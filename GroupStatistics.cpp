@@ -0,0 +1,154 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cmath>
+#include "DefaultParameters.h"
+#include "GroupStatistics.h"
+
+using namespace std;
+
+ColumnStatistics::ColumnStatistics() : count(0), mean(0), squaredDeviations(0), binCounts(MEDIAN_HISTOGRAM_BINS, 0), binSums(MEDIAN_HISTOGRAM_BINS, 0) {
+}
+
+void ColumnStatistics::add(double value)	{
+	++count;
+	double delta = value-mean;
+	mean += delta/((double) count);
+	squaredDeviations += delta*(value-mean);
+
+	uint32_t bin = getBin(value);
+	++binCounts[bin];
+	binSums[bin] += value;
+}
+
+void ColumnStatistics::merge(const ColumnStatistics& statistics)	{
+	if (statistics.count == 0)
+		return;
+
+	if (count == 0)	{
+		*this = statistics;
+		return;
+	}
+
+	// The parallel variant of the Welford's algorithm (Chan et al.).
+	double totalCount = count+statistics.count;
+	double delta = statistics.mean-mean;
+	mean += delta*(statistics.count/totalCount);
+	squaredDeviations += statistics.squaredDeviations+delta*delta*(count*(statistics.count/totalCount));
+	count += statistics.count;
+
+	for (uint32_t b = 0; b < MEDIAN_HISTOGRAM_BINS; ++b)	{
+		binCounts[b] += statistics.binCounts[b];
+		binSums[b] += statistics.binSums[b];
+	}
+}
+
+double ColumnStatistics::getStandardDeviation() const	{
+	if (count < 2)
+		return 0;
+	return sqrt(squaredDeviations/((double) count-1));
+}
+
+double ColumnStatistics::getMedian() const	{
+	if (count == 0)
+		return 0;
+	if ((count % 2) == 0)
+		return (getOrderValue(count/2)+getOrderValue(count/2-1))/2.;
+	else
+		return getOrderValue(count/2);
+}
+
+uint32_t ColumnStatistics::getBin(double value)	{
+	if (!(value > 0))
+		return 0;
+	if (value >= 1)
+		return MEDIAN_HISTOGRAM_BINS-1;
+	return min((uint32_t) (value*MEDIAN_HISTOGRAM_BINS), (uint32_t) MEDIAN_HISTOGRAM_BINS-1);
+}
+
+double ColumnStatistics::getOrderValue(uint64_t k) const	{
+	uint64_t numberOfSmaller = 0;
+	for (uint32_t b = 0; b < MEDIAN_HISTOGRAM_BINS; ++b)	{
+		numberOfSmaller += binCounts[b];
+		if (numberOfSmaller > k)
+			return binSums[b]/((double) binCounts[b]);
+	}
+	return 0;
+}
+
+GroupStatistics::GroupStatistics() : numberOfInstances(0), numberOfColumns(0)	{
+}
+
+void GroupStatistics::addInstance(const InstanceResults& results)	{
+	uint32_t averageWindow = ConfigureScheduleAnalysis::averageWindow;
+	if (numberOfInstances == 0)
+		numberOfColumns = (results.numberOfColumns >= 2 ? (results.numberOfColumns-2)/averageWindow : 0);
+
+	for (map<Parameter, ParameterResult>::const_iterator mit = results.results.begin(); mit != results.results.end(); ++mit)	{
+		Parameter parameter = mit->first;
+		if (parameter < ACTIVITY_DURATION)
+			continue;
+
+		vector<ColumnStatistics>& parameterColumns = columns[parameter];
+		if (parameterColumns.empty())
+			parameterColumns.resize(numberOfColumns);
+		if (descriptions.count(parameter) == 0)
+			descriptions[parameter] = mit->second.description;
+
+		// The first value (the dummy start activity) is skipped, the incomplete window at the end is not shown.
+		const vector<double>& values = mit->second.parameterValues;
+		double sumValue = 0;
+		uint32_t counter = 0, column = 0;
+		for (uint32_t i = 1; i < results.numberOfColumns && i < values.size() && column < parameterColumns.size(); ++i)	{
+			if (counter < averageWindow)	{
+				sumValue += values[i];
+				++counter;
+			} else {
+				double averageValue = sumValue/((double) averageWindow);
+				parameterColumns[column++].add(averageValue);
+				sumValue = values[i]; counter = 1;
+			}
+		}
+	}
+
+	++numberOfInstances;
+}
+
+void GroupStatistics::merge(const GroupStatistics& statistics)	{
+	if (statistics.numberOfInstances == 0)
+		return;
+
+	if (numberOfInstances == 0)	{
+		*this = statistics;
+		return;
+	}
+
+	for (uint32_t p = 0; p < NUMBER_OF_PARAMETERS; ++p)	{
+		if (columns[p].empty() && !statistics.columns[p].empty())
+			columns[p].resize(numberOfColumns);
+		for (uint32_t c = 0; c < columns[p].size() && c < statistics.columns[p].size(); ++c)
+			columns[p][c].merge(statistics.columns[p][c]);
+	}
+	descriptions.insert(statistics.descriptions.begin(), statistics.descriptions.end());
+	numberOfInstances += statistics.numberOfInstances;
+}
+
+string GroupStatistics::getDescription(Parameter parameter) const	{
+	map<Parameter, string>::const_iterator it = descriptions.find(parameter);
+	return (it != descriptions.end() ? it->second : string());
+}
+
@@ -0,0 +1,87 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef GROUP_STATISTICS_H
+#define GROUP_STATISTICS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "VisualizerScheduleStatistics.h"
+
+// The number of bins of the histogram which estimates the median.
+#define MEDIAN_HISTOGRAM_BINS 1024
+
+/*
+ * Online statistics of one column of the group figure. The mean and the variance are updated by the Welford's algorithm
+ * and the median is estimated from a fixed histogram of the interval [0,1], i.e. the range of the normalized values.
+ * Each bin keeps also the sum of its values, the estimate is exact if the values in the bin of the median are equal.
+ * The accumulators of the disjoint sets of values are merged without any loss.
+ */
+class ColumnStatistics {
+	public:
+
+		ColumnStatistics();
+
+		void add(double value);
+		void merge(const ColumnStatistics& statistics);
+
+		uint64_t getCount() const { return count; }
+		double getMean() const { return mean; }
+		double getStandardDeviation() const;
+		double getMedian() const;
+
+	private:
+
+		static uint32_t getBin(double value);
+		// The mean value of the k-th smallest value's bin.
+		double getOrderValue(uint64_t k) const;
+
+		uint64_t count;
+		double mean, squaredDeviations;
+		std::vector<uint64_t> binCounts;
+		std::vector<double> binSums;
+};
+
+/*
+ * Statistics of the analysis results of a group of instances, the memory does not depend on the number of instances.
+ * The number of columns is given by the first added instance, the columns missing in the other instances are skipped.
+ */
+class GroupStatistics {
+	public:
+
+		GroupStatistics();
+
+		// The parameter values of the instance are averaged over the windows of the figure columns and added to the statistics.
+		void addInstance(const InstanceResults& results);
+		void merge(const GroupStatistics& statistics);
+
+		uint64_t getNumberOfInstances() const { return numberOfInstances; }
+		uint32_t getNumberOfColumns() const { return numberOfColumns; }
+		std::string getDescription(Parameter parameter) const;
+		const std::vector<ColumnStatistics>& getColumns(Parameter parameter) const { return columns[parameter]; }
+
+	private:
+
+		uint64_t numberOfInstances;
+		uint32_t numberOfColumns;
+		std::map<Parameter, std::string> descriptions;
+		std::vector<ColumnStatistics> columns[NUMBER_OF_PARAMETERS];
+};
+
+#endif
+
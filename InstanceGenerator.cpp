@@ -0,0 +1,293 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "InstanceGenerator.h"
+
+using namespace std;
+
+InstanceGenerator::InstanceGenerator(const GeneratorParameters& parameters) : parameters(parameters), randomState(1), numberOfActivities(0), projectMakespan(0)	{
+	string method = "InstanceGenerator::InstanceGenerator: ";
+	if (parameters.numberOfActivities < 1 || parameters.numberOfResources < 1)
+		throw invalid_argument(method+"At least one activity and one resource are required!");
+	if (parameters.networkComplexity < 0 || parameters.resourceFactor < 0 || parameters.resourceFactor > 1)
+		throw invalid_argument(method+"Invalid network complexity or resource factor!");
+	if (parameters.resourceStrength < 0 || parameters.resourceStrength > 1)
+		throw invalid_argument(method+"The resource strength has to be in the interval [0, 1]!");
+	if (parameters.minimalDuration > parameters.maximalDuration)
+		throw invalid_argument(method+"Invalid range of the activity durations!");
+	if (parameters.minimalRequirement < 1 || parameters.minimalRequirement > parameters.maximalRequirement)
+		throw invalid_argument(method+"Invalid range of the resource requirements!");
+	if (parameters.maximalMakespan > 0 && parameters.minimalMakespan > parameters.maximalMakespan)
+		throw invalid_argument(method+"Invalid range of the makespan!");
+}
+
+void InstanceGenerator::generate()	{
+	randomState = (((uint64_t) 0x9e3779b9) << 32) ^ (((uint64_t) parameters.seed) << 1) ^ 0x7f4a7c15;
+	numberOfActivities = parameters.numberOfActivities+2;
+
+	generateNetwork();
+	generateRequirements();
+	setCapacities();
+
+	/* FEASIBLE SCHEDULE */
+	uint32_t minimalMakespan = parameters.minimalMakespan, maximalMakespan = parameters.maximalMakespan;
+	uint32_t scheduleSeed = random(1, 0xffffffff);
+	if (generateSchedule(0, scheduleSeed))
+		return;
+	if (maximalMakespan > 0 && projectMakespan > maximalMakespan)
+		throw runtime_error("InstanceGenerator::generate: The makespan range cannot be reached, the schedule without delays is longer!");
+
+	// The activities are delayed randomly, the longest delay is found by the bisection.
+	uint32_t shorterDelay = 0, longerDelay = 1;
+	while (!generateSchedule(longerDelay, scheduleSeed) && projectMakespan < minimalMakespan)	{
+		shorterDelay = longerDelay;
+		longerDelay *= 2;
+	}
+
+	while (projectMakespan < minimalMakespan || (maximalMakespan > 0 && projectMakespan > maximalMakespan))	{
+		if (longerDelay-shorterDelay <= 1)
+			throw runtime_error("InstanceGenerator::generate: The makespan range cannot be reached, it is too narrow!");
+
+		uint32_t delay = (shorterDelay+longerDelay)/2;
+		if (generateSchedule(delay, scheduleSeed))
+			return;
+		if (projectMakespan < minimalMakespan)
+			shorterDelay = delay;
+		else
+			longerDelay = delay;
+	}
+}
+
+void InstanceGenerator::writeToFile(const string& file) const	{
+	vector<uint32_t> words;
+	words.push_back(numberOfActivities);
+	words.push_back(parameters.numberOfResources);
+	words.insert(words.end(), activitiesDuration.begin(), activitiesDuration.end());
+	words.insert(words.end(), resourceCapacities.begin(), resourceCapacities.end());
+	words.insert(words.end(), requiredResources.begin(), requiredResources.end());
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		words.push_back(successors[i].size());
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		words.insert(words.end(), successors[i].begin(), successors[i].end());
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		words.push_back(predecessors[i].size());
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		words.insert(words.end(), predecessors[i].begin(), predecessors[i].end());
+	words.push_back(projectMakespan);
+	words.insert(words.end(), scheduleOrder.begin(), scheduleOrder.end());
+	words.insert(words.end(), startTimesById.begin(), startTimesById.end());
+
+	FILE *output = fopen(file.c_str(), "wb");
+	if (output == NULL)
+		throw runtime_error("InstanceGenerator::writeToFile: Cannot open the output file \""+file+"\"!");
+	bool written = (fwrite(&words[0], sizeof(uint32_t), words.size(), output) == words.size());
+	if (fclose(output) != 0 || !written)
+		throw runtime_error("InstanceGenerator::writeToFile: Cannot write the output file \""+file+"\"!");
+}
+
+uint32_t InstanceGenerator::getNumberOfArcs() const	{
+	uint32_t numberOfArcs = 0;
+	for (vector<vector<uint32_t> >::const_iterator it = successors.begin(); it != successors.end(); ++it)
+		numberOfArcs += it->size();
+	return numberOfArcs;
+}
+
+void InstanceGenerator::generateNetwork()	{
+	uint32_t n = parameters.numberOfActivities;
+	successors.assign(numberOfActivities, vector<uint32_t>());
+	predecessors.assign(numberOfActivities, vector<uint32_t>());
+
+	// The predecessors are chosen from the preceding window, i.e. the depth of the network grows with the number of activities.
+	uint32_t window = max(10u, n/50);
+	uint32_t numberOfStartActivities = min(n, 3+n/100);
+	uint64_t numberOfArcs = 0;
+	for (uint32_t j = numberOfStartActivities+1; j <= n; ++j)	{
+		addArc(random(j > window ? j-window : 1, j-1), j);
+		++numberOfArcs;
+	}
+
+	uint64_t requiredArcs = (uint64_t) floor(parameters.networkComplexity*n+0.5);
+	for (uint64_t attempt = 0; n > 1 && numberOfArcs < requiredArcs && attempt < 20*requiredArcs; ++attempt)	{
+		uint32_t i = random(1, n-1);
+		uint32_t j = i+random(1, min(window, n-i));
+		if (addArc(i, j))
+			++numberOfArcs;
+	}
+
+	/* DUMMY START AND FINISH ACTIVITIES */
+	for (uint32_t j = 1; j <= n; ++j)	{
+		if (predecessors[j].empty())
+			addArc(0, j);
+	}
+	for (uint32_t i = 1; i <= n; ++i)	{
+		if (successors[i].empty())
+			addArc(i, n+1);
+	}
+
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		sort(successors[i].begin(), successors[i].end());
+		sort(predecessors[i].begin(), predecessors[i].end());
+	}
+}
+
+void InstanceGenerator::generateRequirements()	{
+	uint32_t numberOfResources = parameters.numberOfResources;
+	activitiesDuration.assign(numberOfActivities, 0);
+	requiredResources.assign(numberOfActivities*numberOfResources, 0);
+	for (uint32_t i = 1; i+1 < numberOfActivities; ++i)	{
+		activitiesDuration[i] = random(parameters.minimalDuration, parameters.maximalDuration);
+
+		bool requiresResource = false;
+		uint32_t *requirements = &requiredResources[i*numberOfResources];
+		for (uint32_t r = 0; r < numberOfResources; ++r)	{
+			if (randomProbability() < parameters.resourceFactor)	{
+				requirements[r] = random(parameters.minimalRequirement, parameters.maximalRequirement);
+				requiresResource = true;
+			}
+		}
+
+		if (!requiresResource)
+			requirements[random(0, numberOfResources-1)] = random(parameters.minimalRequirement, parameters.maximalRequirement);
+	}
+}
+
+void InstanceGenerator::setCapacities()	{
+	uint32_t numberOfResources = parameters.numberOfResources;
+
+	/* EARLIEST START SCHEDULE */
+	// The arcs lead from lower to higher identifications, i.e. the identifications are a topological order.
+	vector<uint32_t> earliestStart(numberOfActivities, 0);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		for (vector<uint32_t>::const_iterator it = successors[i].begin(); it != successors[i].end(); ++it)
+			earliestStart[*it] = max(earliestStart[*it], earliestStart[i]+activitiesDuration[i]);
+	}
+
+	uint32_t earliestMakespan = earliestStart[numberOfActivities-1];
+	vector<int64_t> utilizationChanges(((size_t) earliestMakespan+1)*numberOfResources, 0);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		for (uint32_t r = 0; r < numberOfResources; ++r)	{
+			utilizationChanges[((size_t) earliestStart[i])*numberOfResources+r] += requiredResources[i*numberOfResources+r];
+			utilizationChanges[((size_t) earliestStart[i]+activitiesDuration[i])*numberOfResources+r] -= requiredResources[i*numberOfResources+r];
+		}
+	}
+
+	/* RESOURCE STRENGTH */
+	resourceCapacities.assign(numberOfResources, 0);
+	for (uint32_t r = 0; r < numberOfResources; ++r)	{
+		uint32_t largestRequirement = 1;
+		for (uint32_t i = 0; i < numberOfActivities; ++i)
+			largestRequirement = max(largestRequirement, requiredResources[i*numberOfResources+r]);
+
+		int64_t utilization = 0, peakUtilization = 0;
+		for (uint32_t t = 0; t <= earliestMakespan; ++t)	{
+			utilization += utilizationChanges[((size_t) t)*numberOfResources+r];
+			peakUtilization = max(peakUtilization, utilization);
+		}
+
+		double difference = max((double) peakUtilization-largestRequirement, 0.);
+		resourceCapacities[r] = largestRequirement+(uint32_t) floor(parameters.resourceStrength*difference+0.5);
+	}
+}
+
+bool InstanceGenerator::generateSchedule(uint32_t maximalDelay, uint32_t seed)	{
+	randomState = (((uint64_t) seed) << 32) | 0x2545f491;
+	uint32_t numberOfResources = parameters.numberOfResources;
+
+	vector<uint32_t> numberOfUnscheduledPredecessors(numberOfActivities);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		numberOfUnscheduledPredecessors[i] = predecessors[i].size();
+
+	scheduleOrder.clear();
+	startTimesById.assign(numberOfActivities, 0);
+	// Utilization of the resources in the time units, it grows with the schedule.
+	vector<uint32_t> utilization;
+	vector<uint32_t> eligibleActivities(1, 0);
+
+	/* SERIAL SCHEDULE GENERATION SCHEME */
+	while (!eligibleActivities.empty())	{
+		uint32_t index = random(0, eligibleActivities.size()-1);
+		uint32_t activityId = eligibleActivities[index];
+		eligibleActivities[index] = eligibleActivities.back();
+		eligibleActivities.pop_back();
+
+		uint32_t start = 0;
+		for (vector<uint32_t>::const_iterator it = predecessors[activityId].begin(); it != predecessors[activityId].end(); ++it)
+			start = max(start, startTimesById[*it]+activitiesDuration[*it]);
+		if (maximalDelay > 0 && activitiesDuration[activityId] > 0)
+			start += random(0, maximalDelay);
+
+		size_t finish = ((size_t) start)+activitiesDuration[activityId];
+		const uint32_t *requirements = &requiredResources[activityId*numberOfResources];
+		for (size_t t = start; t < finish; ++t)	{
+			if (utilization.size() < (t+1)*numberOfResources)
+				utilization.resize(max(2*utilization.size(), (t+1)*numberOfResources), 0);
+			for (uint32_t r = 0; r < numberOfResources; ++r)	{
+				if (utilization[t*numberOfResources+r]+requirements[r] > resourceCapacities[r])	{
+					// The activity cannot be processed at the time t, the start is moved behind it.
+					start = t+1;
+					finish = ((size_t) start)+activitiesDuration[activityId];
+					break;
+				}
+			}
+		}
+
+		if (finish > 0 && utilization.size() < finish*numberOfResources)
+			utilization.resize(max(2*utilization.size(), finish*numberOfResources), 0);
+		for (size_t t = start; t < finish; ++t)	{
+			for (uint32_t r = 0; r < numberOfResources; ++r)
+				utilization[t*numberOfResources+r] += requirements[r];
+		}
+
+		startTimesById[activityId] = start;
+		scheduleOrder.push_back(activityId);
+		for (vector<uint32_t>::const_iterator it = successors[activityId].begin(); it != successors[activityId].end(); ++it)	{
+			if (--numberOfUnscheduledPredecessors[*it] == 0)
+				eligibleActivities.push_back(*it);
+		}
+	}
+
+	projectMakespan = startTimesById[numberOfActivities-1];
+	bool longEnough = (projectMakespan >= parameters.minimalMakespan);
+	bool shortEnough = (parameters.maximalMakespan == 0 || projectMakespan <= parameters.maximalMakespan);
+	return longEnough && shortEnough;
+}
+
+bool InstanceGenerator::addArc(uint32_t from, uint32_t to)	{
+	if (find(successors[from].begin(), successors[from].end(), to) != successors[from].end())
+		return false;
+	successors[from].push_back(to);
+	predecessors[to].push_back(from);
+	return true;
+}
+
+uint32_t InstanceGenerator::random(uint32_t minimum, uint32_t maximum)	{
+	// xorshift64* generator, the same sequence on all platforms.
+	randomState ^= randomState >> 12;
+	randomState ^= randomState << 25;
+	randomState ^= randomState >> 27;
+	uint64_t value = (randomState*((((uint64_t) 0x2545f491) << 32) | 0x4f6cdd1d)) >> 32;
+	uint64_t range = ((uint64_t) maximum)-minimum+1;
+	return minimum+(uint32_t) (value % range);
+}
+
+double InstanceGenerator::randomProbability()	{
+	return random(0, 0xffffffff)/4294967296.;
+}
+
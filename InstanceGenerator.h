@@ -0,0 +1,86 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+struct GeneratorParameters	{
+	// The number of non-dummy activities, the dummy start and finish activities are added.
+	uint32_t numberOfActivities;
+	uint32_t numberOfResources;
+	// Network complexity, i.e. the average number of the arcs per non-dummy activity.
+	double networkComplexity;
+	// Resource factor, i.e. the average portion of the resources required by an activity.
+	double resourceFactor;
+	// Resource strength, 0 ~ the capacity is the largest requirement, 1 ~ the peak of the earliest start schedule.
+	double resourceStrength;
+	uint32_t minimalDuration, maximalDuration;
+	uint32_t minimalRequirement, maximalRequirement;
+	// The schedule is delayed randomly to reach the makespan range, 0 ~ no limit.
+	uint32_t minimalMakespan, maximalMakespan;
+	uint32_t seed;
+};
+
+/*
+ * Random RCPSP instance and its feasible schedule in the layout of the result files (see ScheduleInstance.h).
+ * The precedence graph is acyclic, the arcs lead from lower to higher activity identifications.
+ * The schedule is built by the serial schedule generation scheme with a random eligible activity selection.
+ */
+class InstanceGenerator {
+	public:
+
+		InstanceGenerator(const GeneratorParameters& parameters);
+
+		void generate();
+		void writeToFile(const std::string& file) const;
+
+		uint32_t getMakespan() const { return projectMakespan; }
+		uint32_t getNumberOfArcs() const;
+
+	private:
+
+		void generateNetwork();
+		void generateRequirements();
+		void setCapacities();
+		// It returns false if the makespan range was not reached.
+		bool generateSchedule(uint32_t maximalDelay, uint32_t seed);
+		bool addArc(uint32_t from, uint32_t to);
+
+		// Uniformly distributed number in [minimum, maximum] by the xorshift generator.
+		uint32_t random(uint32_t minimum, uint32_t maximum);
+		double randomProbability();
+
+		GeneratorParameters parameters;
+		uint64_t randomState;
+
+		uint32_t numberOfActivities;
+		std::vector<uint32_t> activitiesDuration;
+		std::vector<uint32_t> resourceCapacities;
+		std::vector<uint32_t> requiredResources;
+		std::vector<std::vector<uint32_t> > successors;
+		std::vector<std::vector<uint32_t> > predecessors;
+
+		uint32_t projectMakespan;
+		std::vector<uint32_t> scheduleOrder;
+		std::vector<uint32_t> startTimesById;
+};
+
+#endif
+
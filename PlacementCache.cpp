@@ -0,0 +1,175 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "ContentHash.h"
+#include "DefaultParameters.h"
+#include "PlacementCache.h"
+
+#ifdef __GNUC__
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+// Version of the cache files, it has to be increased if the placement model is changed.
+#define CACHE_VERSION 1
+#define CACHE_MAGIC "RCPSPBLK"
+#define CACHE_MAGIC_LENGTH 8
+
+using namespace std;
+
+PlacementCache::PlacementCache(const string& directory) : directory(directory)	{
+	#ifdef __GNUC__
+	struct stat status;
+	if (mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+		throw invalid_argument("PlacementCache::PlacementCache: Cannot create the cache directory \""+directory+"\"!");
+	if (stat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode))
+		throw invalid_argument("PlacementCache::PlacementCache: \""+directory+"\" is not a directory!");
+	#endif
+}
+
+bool PlacementCache::load(uint32_t capacity, const vector<uint32_t>& startTimes, const vector<uint32_t>& durations,
+		const vector<uint32_t>& requirements, vector<pair<uint32_t, uint32_t> >& positions) const	{
+
+	string key = getKey(capacity, startTimes, durations, requirements);
+	FILE *file = fopen(getFileName(key).c_str(), "rb");
+	if (file == NULL)
+		return false;
+
+	string content;
+	char buffer[4096];
+	size_t size;
+	while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		content.append(buffer, size);
+	bool readError = (ferror(file) != 0);
+	fclose(file);
+
+	/* VALIDATE THE CACHE FILE */
+	size_t numberOfBlocks = startTimes.size();
+	size_t headerSize = CACHE_MAGIC_LENGTH+key.size();
+	if (readError || content.size() != headerSize+numberOfBlocks*sizeof(uint32_t))
+		return false;
+	if (content.compare(0, CACHE_MAGIC_LENGTH, CACHE_MAGIC) != 0 || content.compare(CACHE_MAGIC_LENGTH, key.size(), key) != 0)
+		return false;
+
+	vector<pair<uint32_t, uint32_t> > cachedPositions;
+	for (uint32_t i = 0; i < numberOfBlocks; ++i)	{
+		uint32_t offset;
+		memcpy(&offset, content.data()+headerSize+i*sizeof(uint32_t), sizeof(uint32_t));
+		if (offset > capacity || requirements[i] > capacity-offset)
+			return false;
+		cachedPositions.push_back(pair<uint32_t, uint32_t>(i, offset));
+	}
+
+	positions.swap(cachedPositions);
+	return true;
+}
+
+void PlacementCache::save(uint32_t capacity, const vector<uint32_t>& startTimes, const vector<uint32_t>& durations,
+		const vector<uint32_t>& requirements, const vector<pair<uint32_t, uint32_t> >& positions) const	{
+
+	vector<uint32_t> offsets(startTimes.size());
+	vector<bool> placed(startTimes.size(), false);
+	for (vector<pair<uint32_t, uint32_t> >::const_iterator it = positions.begin(); it != positions.end(); ++it)	{
+		if (it->first >= offsets.size() || placed[it->first])
+			return;
+		offsets[it->first] = it->second;
+		placed[it->first] = true;
+	}
+
+	if (find(placed.begin(), placed.end(), false) != placed.end())
+		return;
+
+	string key = getKey(capacity, startTimes, durations, requirements);
+	string content = CACHE_MAGIC+key;
+	if (!offsets.empty())
+		content.append((const char*) &offsets[0], offsets.size()*sizeof(uint32_t));
+
+	string fileName = getFileName(key);
+	#ifdef __GNUC__
+	// The complete file is renamed to the cache file, i.e. the readers never see a partially written file.
+	string temporaryName = fileName+".XXXXXX";
+	vector<char> nameBuffer(temporaryName.begin(), temporaryName.end());
+	nameBuffer.push_back('\0');
+	int fd = mkstemp(&nameBuffer[0]);
+	if (fd < 0)
+		return;
+
+	bool written = true;
+	const char *data = content.data();
+	size_t length = content.size();
+	while (length > 0 && written)	{
+		ssize_t size = write(fd, data, length);
+		if (size < 0 && errno == EINTR)
+			continue;
+		written = (size > 0);
+		if (written)	{
+			data += size;
+			length -= size;
+		}
+	}
+
+	if (close(fd) != 0 || !written || rename(&nameBuffer[0], fileName.c_str()) != 0)
+		unlink(&nameBuffer[0]);
+	#else
+	FILE *file = fopen(fileName.c_str(), "wb");
+	if (file == NULL)
+		return;
+	bool written = (fwrite(content.data(), 1, content.size(), file) == content.size());
+	if (fclose(file) != 0 || !written)
+		remove(fileName.c_str());
+	#endif
+}
+
+string PlacementCache::getKey(uint32_t capacity, const vector<uint32_t>& startTimes,
+		const vector<uint32_t>& durations, const vector<uint32_t>& requirements)	{
+
+	// The placement does not depend on the position of the blocks on the time axis.
+	uint32_t earliestStart = (startTimes.empty() ? 0 : *min_element(startTimes.begin(), startTimes.end()));
+
+	uint32_t mipGap[2];
+	memcpy(mipGap, &ConfigureILPSolver::mipGap, sizeof(mipGap));
+
+	vector<uint32_t> values;
+	values.push_back(CACHE_VERSION);
+	values.push_back(ConfigureILPSolver::branchingTechnique);
+	values.push_back(ConfigureILPSolver::backtrackingTechnique);
+	values.push_back(ConfigureILPSolver::timeLimit);
+	values.push_back(mipGap[0]);
+	values.push_back(mipGap[1]);
+	values.push_back(capacity);
+	values.push_back(startTimes.size());
+	for (uint32_t i = 0; i < startTimes.size(); ++i)	{
+		values.push_back(startTimes[i]-earliestStart);
+		values.push_back(durations[i]);
+		values.push_back(requirements[i]);
+	}
+
+	return string((const char*) &values[0], values.size()*sizeof(uint32_t));
+}
+
+string PlacementCache::getFileName(const string& key) const	{
+	ContentHash hash;
+	hash.update(key);
+	return directory+"/"+hash.getHexValue()+".blk";
+}
+
@@ -0,0 +1,54 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PLACEMENT_CACHE_H
+#define PLACEMENT_CACHE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+/*
+ * On-disk cache of the block placements found by the ILP solver. The placement of a single resource problem
+ * is stored in the file named by the hash of the problem (capacity, blocks, and the solver settings).
+ * The problem is stored in the file as well, i.e. the hash collisions are detected. The files are written
+ * atomically, the cache can be shared by concurrently running programs.
+ */
+class PlacementCache {
+	public:
+
+		// The directory is created if it does not exist.
+		PlacementCache(const std::string& directory);
+
+		// The positions are pairs (index of the block, y offset) as returned by the block placers.
+		bool load(uint32_t capacity, const std::vector<uint32_t>& startTimes, const std::vector<uint32_t>& durations,
+				const std::vector<uint32_t>& requirements, std::vector<std::pair<uint32_t, uint32_t> >& positions) const;
+		// The cache is only an optimization, the write errors are ignored.
+		void save(uint32_t capacity, const std::vector<uint32_t>& startTimes, const std::vector<uint32_t>& durations,
+				const std::vector<uint32_t>& requirements, const std::vector<std::pair<uint32_t, uint32_t> >& positions) const;
+
+	private:
+
+		static std::string getKey(uint32_t capacity, const std::vector<uint32_t>& startTimes,
+				const std::vector<uint32_t>& durations, const std::vector<uint32_t>& requirements);
+		std::string getFileName(const std::string& key) const;
+
+		std::string directory;
+};
+
+#endif
+
@@ -0,0 +1,346 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include "BufferedWriter.h"
+#include "Profiler.h"
+
+#ifdef __GNUC__
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+struct FileProfile	{
+	string file;
+	vector<StageProfile> stages;
+};
+
+bool Profiler::enabled = false;
+
+namespace	{
+	vector<FileProfile> profiledFiles;
+	vector<StageProfile> batchStages;
+	#ifdef __GNUC__
+	pthread_mutex_t profilerMutex = PTHREAD_MUTEX_INITIALIZER;
+	__thread int32_t currentFile = -1;
+	#ifdef COUNT_ALLOCATIONS
+	__thread uint64_t numberOfAllocations = 0;
+	#endif
+	#else
+	int32_t currentFile = -1;
+	#endif
+	// It is set by Profiler::enable before the threads are started, the threads only read it.
+	bool countersAvailable = false;
+}
+
+#if defined(__GNUC__) && defined(COUNT_ALLOCATIONS)
+/*
+ * The allocations are counted per thread by the replaced global operators, they are compiled in only if COUNT_ALLOCATIONS
+ * is defined (make COUNT_ALLOCATIONS=1), i.e. the allocations of the regular builds are not routed through this code.
+ * All the replaceable forms except the aligned ones (C++17) are replaced, the aligned forms keep the library pair.
+ */
+#if __cplusplus >= 201103L
+#define BAD_ALLOC_EXCEPTION
+#define NO_EXCEPTIONS noexcept
+#else
+#define BAD_ALLOC_EXCEPTION throw(bad_alloc)
+#define NO_EXCEPTIONS throw()
+#endif
+
+static void* countedAllocation(size_t size)	{
+	++numberOfAllocations;
+	return malloc(size > 0 ? size : 1);
+}
+
+void* operator new(size_t size) BAD_ALLOC_EXCEPTION	{
+	void *memory = countedAllocation(size);
+	if (memory == NULL)
+		throw bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size) BAD_ALLOC_EXCEPTION	{
+	void *memory = countedAllocation(size);
+	if (memory == NULL)
+		throw bad_alloc();
+	return memory;
+}
+
+void* operator new(size_t size, const nothrow_t&) NO_EXCEPTIONS	{
+	return countedAllocation(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) NO_EXCEPTIONS	{
+	return countedAllocation(size);
+}
+
+void operator delete(void *memory) NO_EXCEPTIONS	{
+	free(memory);
+}
+
+void operator delete[](void *memory) NO_EXCEPTIONS	{
+	free(memory);
+}
+
+void operator delete(void *memory, const nothrow_t&) NO_EXCEPTIONS	{
+	free(memory);
+}
+
+void operator delete[](void *memory, const nothrow_t&) NO_EXCEPTIONS	{
+	free(memory);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void *memory, size_t) NO_EXCEPTIONS	{
+	free(memory);
+}
+
+void operator delete[](void *memory, size_t) NO_EXCEPTIONS	{
+	free(memory);
+}
+#endif
+#endif
+
+void Profiler::enable()	{
+	enabled = true;
+	// The perf events are probed once, i.e. the system calls are not repeated if they are not permitted.
+	int counters[2] = { -1, -1 };
+	countersAvailable = openCounters(counters);
+	#ifdef __linux__
+	for (uint32_t c = 0; c < 2; ++c)	{
+		if (counters[c] >= 0)
+			close(counters[c]);
+	}
+	#endif
+}
+
+int32_t Profiler::beginFile(const string& file)	{
+	if (!enabled)
+		return -1;
+
+	FileProfile profile;
+	profile.file = file;
+	#ifdef __GNUC__
+	pthread_mutex_lock(&profilerMutex);
+	#endif
+	profiledFiles.push_back(profile);
+	int32_t index = profiledFiles.size()-1;
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&profilerMutex);
+	#endif
+
+	currentFile = index;
+	return index;
+}
+
+int32_t Profiler::getCurrentFile()	{
+	return currentFile;
+}
+
+void Profiler::setCurrentFile(int32_t file)	{
+	currentFile = file;
+}
+
+void Profiler::addStage(const StageProfile& stage)	{
+	#ifdef __GNUC__
+	pthread_mutex_lock(&profilerMutex);
+	#endif
+	if (currentFile >= 0 && currentFile < (int32_t) profiledFiles.size())
+		profiledFiles[currentFile].stages.push_back(stage);
+	else
+		batchStages.push_back(stage);
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&profilerMutex);
+	#endif
+}
+
+void Profiler::writeReport(const string& file)	{
+	BufferedWriter report(file);
+	report<<"{\n\t\"batch\": ";
+	writeStages(report, batchStages, "\t\t");
+	report<<",\n\t\"files\": [";
+	for (vector<FileProfile>::const_iterator it = profiledFiles.begin(); it != profiledFiles.end(); ++it)	{
+		report<<(it == profiledFiles.begin() ? "\n" : ",\n");
+		report<<"\t\t{\n\t\t\t\"file\": \""<<escapeJSON(it->file)<<"\",\n\t\t\t\"stages\": ";
+		writeStages(report, it->stages, "\t\t\t\t");
+		report<<"\n\t\t}";
+	}
+	report<<"\n\t]\n}\n";
+	report.close();
+}
+
+uint64_t Profiler::getNumberOfAllocations()	{
+	#if defined(__GNUC__) && defined(COUNT_ALLOCATIONS)
+	return numberOfAllocations;
+	#else
+	return UNAVAILABLE_COUNTER;
+	#endif
+}
+
+void Profiler::writeStages(BufferedWriter& report, const vector<StageProfile>& stages, const char *indentation)	{
+	report<<"[";
+	for (vector<StageProfile>::const_iterator it = stages.begin(); it != stages.end(); ++it)	{
+		report<<(it == stages.begin() ? "\n" : ",\n");
+		report<<indentation<<"{ \"name\": \""<<escapeJSON(it->name)<<"\", \"wall_time\": ";
+		report.writeFixed(it->wallTime, 6)<<", \"cpu_time\": ";
+		report.writeFixed(it->cpuTime, 6)<<", \"child_cpu_time\": ";
+		report.writeFixed(it->childCpuTime, 6)<<", \"peak_rss_kb\": "<<it->peakResidentSize;
+		report<<", \"allocations\": ";
+		if (it->numberOfAllocations != UNAVAILABLE_COUNTER)
+			report<<it->numberOfAllocations;
+		else
+			report<<"null";
+		report<<", \"cycles\": ";
+		if (it->cycles != UNAVAILABLE_COUNTER)
+			report<<it->cycles;
+		else
+			report<<"null";
+		report<<", \"cache_misses\": ";
+		if (it->cacheMisses != UNAVAILABLE_COUNTER)
+			report<<it->cacheMisses;
+		else
+			report<<"null";
+		report<<" }";
+	}
+	report<<"]";
+}
+
+string Profiler::escapeJSON(const string& text)	{
+	string escaped;
+	for (string::const_iterator it = text.begin(); it != text.end(); ++it)	{
+		if (*it == '"' || *it == '\\')	{
+			escaped += '\\';
+			escaped += *it;
+		} else if ((unsigned char) *it < 0x20)	{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", (unsigned char) *it);
+			escaped += code;
+		} else {
+			escaped += *it;
+		}
+	}
+	return escaped;
+}
+
+bool Profiler::openCounters(int counters[2])	{
+	#ifdef __linux__
+	uint64_t events[2] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES };
+	for (uint32_t c = 0; c < 2; ++c)	{
+		struct perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.size = sizeof(attributes);
+		attributes.config = events[c];
+		attributes.disabled = 1;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		// The counter of the calling thread on any processor.
+		counters[c] = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+		if (counters[c] < 0)
+			return false;
+		ioctl(counters[c], PERF_EVENT_IOC_RESET, 0);
+		ioctl(counters[c], PERF_EVENT_IOC_ENABLE, 0);
+	}
+	return true;
+	#else
+	return false;
+	#endif
+}
+
+ProfiledStage::ProfiledStage(const string& name) : active(Profiler::isEnabled())	{
+	counters[0] = counters[1] = -1;
+	if (!active)
+		return;
+
+	stage.name = name;
+	stage.childCpuTime = 0;
+
+	if (countersAvailable)
+		Profiler::openCounters(counters);
+
+	startAllocations = Profiler::getNumberOfAllocations();
+	startCpuTime = getCpuTime();
+	startWallTime = getWallTime();
+}
+
+void ProfiledStage::finish()	{
+	if (!active)
+		return;
+	active = false;
+
+	stage.wallTime = getWallTime()-startWallTime;
+	stage.cpuTime = getCpuTime()-startCpuTime;
+	stage.numberOfAllocations = (startAllocations != UNAVAILABLE_COUNTER ? Profiler::getNumberOfAllocations()-startAllocations : UNAVAILABLE_COUNTER);
+
+	uint64_t values[2] = { UNAVAILABLE_COUNTER, UNAVAILABLE_COUNTER };
+	for (uint32_t c = 0; c < 2; ++c)	{
+		#ifdef __linux__
+		if (counters[c] >= 0)	{
+			uint64_t value = 0;
+			if (read(counters[c], &value, sizeof(value)) == sizeof(value) && counters[0] >= 0 && counters[1] >= 0)
+				values[c] = value;
+			close(counters[c]);
+		}
+		#endif
+	}
+	stage.cycles = values[0];
+	stage.cacheMisses = values[1];
+
+	stage.peakResidentSize = 0;
+	#ifdef __GNUC__
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		stage.peakResidentSize = usage.ru_maxrss;
+	#endif
+
+	Profiler::addStage(stage);
+}
+
+double ProfiledStage::getWallTime()	{
+	#ifdef __GNUC__
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec+time.tv_nsec/1e9;
+	#else
+	return ((double) clock())/CLOCKS_PER_SEC;
+	#endif
+}
+
+double ProfiledStage::getCpuTime()	{
+	#ifdef __GNUC__
+	struct timespec time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return time.tv_sec+time.tv_nsec/1e9;
+	#else
+	return ((double) clock())/CLOCKS_PER_SEC;
+	#endif
+}
+
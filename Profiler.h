@@ -0,0 +1,107 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// Value of the hardware counter which is not available, e.g. the perf events are not permitted.
+#define UNAVAILABLE_COUNTER (~((uint64_t) 0))
+
+struct StageProfile	{
+	std::string name;
+	// The wall and CPU (calling thread) times in seconds, the CPU time of the solver processes is separated.
+	double wallTime, cpuTime, childCpuTime;
+	// Peak resident set size of the whole program in kilobytes at the end of the stage.
+	uint64_t peakResidentSize;
+	// The number of allocations of the calling thread, they are counted only by the COUNT_ALLOCATIONS builds.
+	uint64_t numberOfAllocations;
+	uint64_t cycles, cacheMisses;
+};
+
+/*
+ * Measurement of the processing stages, the stages of each input file are recorded separately.
+ * The stages are assigned to the file of the calling thread (see setCurrentFile), the stages outside
+ * the files belong to the batch. The stages can be nested, e.g. the ILP is a part of the chart write.
+ * The profiling is disabled by default, the disabled stages are not measured at all.
+ */
+class Profiler {
+	public:
+
+		// It has to be called before the worker threads are started, the availability of the perf events is probed.
+		static void enable();
+		static bool isEnabled() { return enabled; }
+
+		// The file is registered and it becomes the current file of the calling thread, its index is returned.
+		static int32_t beginFile(const std::string& file);
+		// -1 ~ no file, i.e. the batch.
+		static int32_t getCurrentFile();
+		static void setCurrentFile(int32_t file);
+
+		static void addStage(const StageProfile& stage);
+		// The JSON report of all the recorded stages.
+		static void writeReport(const std::string& file);
+
+		// The number of allocations of the calling thread since its start, UNAVAILABLE_COUNTER if they are not counted.
+		static uint64_t getNumberOfAllocations();
+
+		// The perf events (cycles, cache misses) of the calling thread, false if they are not available.
+		static bool openCounters(int counters[2]);
+
+	private:
+
+		static void writeStages(class BufferedWriter& report, const std::vector<StageProfile>& stages, const char *indentation);
+		static std::string escapeJSON(const std::string& text);
+
+		static bool enabled;
+};
+
+/*
+ * The stage is measured from the construction to the destruction of the object.
+ */
+class ProfiledStage {
+	public:
+
+		ProfiledStage(const std::string& name);
+		~ProfiledStage() { finish(); }
+
+		// The stage is recorded, the later calls do nothing.
+		void finish();
+
+		void setName(const std::string& name) { stage.name = name; }
+		void addChildCpuTime(double seconds) { stage.childCpuTime += seconds; }
+
+	private:
+
+		ProfiledStage(const ProfiledStage&);
+		ProfiledStage& operator=(const ProfiledStage&);
+
+		static double getWallTime();
+		static double getCpuTime();
+
+		bool active;
+		StageProfile stage;
+		double startWallTime, startCpuTime;
+		uint64_t startAllocations;
+		// The perf events (cycles, cache misses), -1 ~ not available.
+		int counters[2];
+};
+
+#endif
+
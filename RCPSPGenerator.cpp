@@ -0,0 +1,158 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "InstanceGenerator.h"
+
+using namespace std;
+
+bool parseNumber(const char *text, uint32_t& value)	{
+	char *end = NULL;
+	value = strtoul(text, &end, 10);
+	return end != text && *end == '\0';
+}
+
+bool parseNumber(const char *text, double& value)	{
+	char *end = NULL;
+	value = strtod(text, &end);
+	return end != text && *end == '\0';
+}
+
+// The range is written as MIN:MAX.
+bool parseRange(const char *text, uint32_t& minimum, uint32_t& maximum)	{
+	string range = text;
+	size_t colon = range.find(':');
+	if (colon == string::npos)
+		return false;
+	return parseNumber(range.substr(0, colon).c_str(), minimum) && parseNumber(range.substr(colon+1).c_str(), maximum);
+}
+
+void printUsage(const GeneratorParameters& defaults)	{
+	cerr<<"Usage: RCPSPGenerator [options] output_file.res"<<endl;
+	cerr<<"\t-n, --activities N\tnumber of non-dummy activities (default "<<defaults.numberOfActivities<<")"<<endl;
+	cerr<<"\t-r, --resources K\tnumber of resources (default "<<defaults.numberOfResources<<")"<<endl;
+	cerr<<"\t-c, --complexity NC\taverage number of arcs per activity (default "<<defaults.networkComplexity<<")"<<endl;
+	cerr<<"\t-f, --factor RF\t\tresource factor in [0, 1] (default "<<defaults.resourceFactor<<")"<<endl;
+	cerr<<"\t-s, --strength RS\tresource strength in [0, 1] (default "<<defaults.resourceStrength<<")"<<endl;
+	cerr<<"\t-d, --durations MIN:MAX\trange of the activity durations (default "<<defaults.minimalDuration<<":"<<defaults.maximalDuration<<")"<<endl;
+	cerr<<"\t-q, --requirements MIN:MAX\trange of the resource requirements (default "<<defaults.minimalRequirement<<":"<<defaults.maximalRequirement<<")"<<endl;
+	cerr<<"\t-m, --makespan MIN:MAX\trange of the schedule makespan, the activities are delayed if required (default no limit)"<<endl;
+	cerr<<"\t-S, --seed N\t\tseed of the random generator (default "<<defaults.seed<<")"<<endl;
+	cerr<<"\t-k, --instances N\tnumber of generated files, the files output_file_1.res, ... are written if N > 1 (default 1)"<<endl;
+}
+
+int main(int argc, char* argv[])	{
+	cout<<"Copyright 2012, 2013, 2015 Libor Bukata and Premysl Sucha."<<endl;
+	cout<<"The program is distributed under the terms of the GNU General Public License."<<endl;
+	cout<<"RCPSP instance and schedule generator."<<endl<<endl;
+
+	GeneratorParameters parameters;
+	parameters.numberOfActivities = 30;
+	parameters.numberOfResources = 4;
+	parameters.networkComplexity = 1.5;
+	parameters.resourceFactor = 0.5;
+	parameters.resourceStrength = 0.5;
+	parameters.minimalDuration = 1;
+	parameters.maximalDuration = 10;
+	parameters.minimalRequirement = 1;
+	parameters.maximalRequirement = 10;
+	parameters.minimalMakespan = 0;
+	parameters.maximalMakespan = 0;
+	parameters.seed = 1;
+	const GeneratorParameters defaults = parameters;
+
+	/* PARSE PROGRAM ARGUMENTS */
+	string outputFile;
+	uint32_t numberOfInstances = 1;
+	for (int i = 1; i < argc; ++i)	{
+		string argument = argv[i];
+		const char *value = (i+1 < argc ? argv[i+1] : "");
+		bool valid = true;
+		if (argument == "-n" || argument == "--activities")	{
+			valid = parseNumber(value, parameters.numberOfActivities);
+		} else if (argument == "-r" || argument == "--resources")	{
+			valid = parseNumber(value, parameters.numberOfResources);
+		} else if (argument == "-c" || argument == "--complexity")	{
+			valid = parseNumber(value, parameters.networkComplexity);
+		} else if (argument == "-f" || argument == "--factor")	{
+			valid = parseNumber(value, parameters.resourceFactor);
+		} else if (argument == "-s" || argument == "--strength")	{
+			valid = parseNumber(value, parameters.resourceStrength);
+		} else if (argument == "-d" || argument == "--durations")	{
+			valid = parseRange(value, parameters.minimalDuration, parameters.maximalDuration);
+		} else if (argument == "-q" || argument == "--requirements")	{
+			valid = parseRange(value, parameters.minimalRequirement, parameters.maximalRequirement);
+		} else if (argument == "-m" || argument == "--makespan")	{
+			valid = parseRange(value, parameters.minimalMakespan, parameters.maximalMakespan);
+		} else if (argument == "-S" || argument == "--seed")	{
+			valid = parseNumber(value, parameters.seed);
+		} else if (argument == "-k" || argument == "--instances")	{
+			valid = parseNumber(value, numberOfInstances) && numberOfInstances > 0;
+		} else if (argument == "-h" || argument == "--help")	{
+			printUsage(defaults);
+			return 0;
+		} else {
+			outputFile = argument;
+			continue;
+		}
+
+		if (!valid)	{
+			cerr<<"Invalid value of the option "<<argument<<"!"<<endl;
+			printUsage(defaults);
+			return 1;
+		}
+		++i;
+	}
+
+	if (outputFile.empty())	{
+		cerr<<"The output file is not specified!"<<endl;
+		printUsage(defaults);
+		return 1;
+	}
+
+	/* GENERATE INSTANCES */
+	string baseName = outputFile;
+	if (baseName.size() > 4 && baseName.substr(baseName.size()-4) == ".res")
+		baseName.erase(baseName.size()-4);
+
+	try {
+		for (uint32_t k = 1; k <= numberOfInstances; ++k)	{
+			string file = outputFile;
+			if (numberOfInstances > 1)	{
+				stringstream name(stringstream::in | stringstream::out);
+				name<<baseName<<"_"<<k<<".res";
+				file = name.str();
+			}
+
+			GeneratorParameters instanceParameters = parameters;
+			instanceParameters.seed = parameters.seed+k-1;
+			InstanceGenerator generator(instanceParameters);
+			generator.generate();
+			generator.writeToFile(file);
+			clog<<file<<": Instance with "<<generator.getNumberOfArcs()<<" arcs and makespan "<<generator.getMakespan()<<" was written!"<<endl;
+		}
+	} catch (exception& e)	{
+		cerr<<e.what()<<endl;
+		return 1;
+	}
+
+	return 0;
+}
+
@@ -24,12 +24,50 @@
 #include <string>
 #include <vector>
 
+#include "AnalysisDataFile.h"
+#include "BatchManifest.h"
+#include "ContentHash.h"
+#include "DefaultParameters.h"
+#include "GroupStatistics.h"
+#include "PlacementCache.h"
+#include "Profiler.h"
+#include "ScheduleInstance.h"
 #include "VisualizerGraph.h"
 #include "VisualizerResourceUtilization.h"
 #include "VisualizerScheduleStatistics.h"
+#include "WorkerPool.h"
+
+// It has to be increased if the outputs of the program are changed, the incremental mode regenerates all the outputs then.
+#define PROGRAM_VERSION "1.1"
+#define MANIFEST_FILE "RCPSPVisualizer.manifest"
+// The exported analysis data can be given instead of the result files, only the group statistics are computed from them.
+#define ANALYSIS_DATA_SUFFIX "_ST.bin"
 
 using namespace std;
 
+struct InstanceTask {
+	string filename;
+	string baseName;
+	uint32_t instanceParameter;
+	bool analysed;
+	InstanceResults results;
+};
+
+#ifdef __GNUC__
+pthread_mutex_t outputMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void printMessage(ostream& output, const string& message)	{
+	// Messages of the concurrently processed files must not be interleaved.
+	#ifdef __GNUC__
+	pthread_mutex_lock(&outputMutex);
+	#endif
+	output<<message<<endl;
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&outputMutex);
+	#endif
+}
+
 bool fileSystemSeperator(const char& c)	{
 	if (c == '/' || c == '\\')
 		return true;
@@ -37,15 +75,365 @@ bool fileSystemSeperator(const char& c)	{
 		return false;
 }
 
+const char* figureExtension(FigureFormat format)	{
+	switch (format)	{
+		case SVG_FORMAT:
+			return ".svg";
+		case PDF_FORMAT:
+			return ".pdf";
+		default:
+			return ".tex";
+	}
+}
+
+/*
+ * The analysis results are added to the group statistics in the order of the program arguments, i.e. independently of the order
+ * of finished files, and they are released at once. Only the results of the files finished ahead of the earlier files are kept.
+ */
+class StatisticsCollector {
+	public:
+		StatisticsCollector(vector<InstanceTask>& tasks);
+		~StatisticsCollector();
+
+		void taskFinished(const InstanceTask& task);
+		const map<uint32_t, GroupStatistics>& getGroups() const { return groups; }
+
+	private:
+
+		StatisticsCollector(const StatisticsCollector&);
+		StatisticsCollector& operator=(const StatisticsCollector&);
+
+		vector<InstanceTask>& tasks;
+		vector<bool> finished;
+		uint32_t nextTask;
+		map<uint32_t, GroupStatistics> groups;
+		#ifdef __GNUC__
+		pthread_mutex_t mutex;
+		#endif
+};
+
+StatisticsCollector::StatisticsCollector(vector<InstanceTask>& tasks) : tasks(tasks), finished(tasks.size(), false), nextTask(0)	{
+	#ifdef __GNUC__
+	pthread_mutex_init(&mutex, NULL);
+	#endif
+}
+
+StatisticsCollector::~StatisticsCollector()	{
+	#ifdef __GNUC__
+	pthread_mutex_destroy(&mutex);
+	#endif
+}
+
+void StatisticsCollector::taskFinished(const InstanceTask& task)	{
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+	finished[&task-&tasks[0]] = true;
+	while (nextTask < tasks.size() && finished[nextTask])	{
+		InstanceTask& nextInstance = tasks[nextTask++];
+		if (nextInstance.analysed)
+			groups[nextInstance.instanceParameter].addInstance(nextInstance.results);
+		nextInstance.results = InstanceResults();
+	}
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+}
+
+class InstanceJob : public Job {
+	public:
+		InstanceJob(InstanceTask& task, FigureFormat format, BlocksPlacerType placer, bool exportData, bool reducedGraph, const PlacementCache *cache,
+				BatchManifest *manifest, StatisticsCollector& collector, WorkerPool& pool) : task(task), format(format), placer(placer),
+			exportData(exportData), reducedGraph(reducedGraph), cache(cache), manifest(manifest), collector(collector), pool(pool) { };
+		void run();
+	private:
+		void processFile();
+		static bool isAnalysisDataFile(const string& file);
+		bool isUpToDate(const string& output) const;
+		bool isChartUpToDate(const string& chart) const;
+		void recordOutput(const string& output);
+		void recordOutputs(const vector<string>& outputs);
+		static string joinFiles(const vector<string>& files);
+
+		InstanceTask& task;
+		FigureFormat format;
+		BlocksPlacerType placer;
+		bool exportData;
+		bool reducedGraph;
+		const PlacementCache *cache;
+		// The incremental mode, the up to date outputs are not generated again.
+		BatchManifest *manifest;
+		string inputHash;
+		StatisticsCollector& collector;
+		// The block placements of all the files are scheduled by the same pool.
+		WorkerPool& pool;
+};
+
+void InstanceJob::run()	{
+	Profiler::beginFile(task.filename);
+	try {
+		processFile();
+	} catch (exception& e)	{
+		printMessage(cerr, e.what());
+	}
+	Profiler::setCurrentFile(-1);
+	collector.taskFinished(task);
+}
+
+void InstanceJob::processFile()	{
+	string filename = task.filename, baseName = task.baseName;
+	string graphFile = baseName+"_GH.dot";
+	string resourceUtilizationFile = baseName+"_RU"+figureExtension(format);
+	string resourceUtilizationILPFile = baseName+"_RU_ILP"+figureExtension(format);
+	string instanceStatisticsFile = baseName+"_ST"+figureExtension(format);
+	string analysisDataFile = baseName+ANALYSIS_DATA_SUFFIX;
+
+	if (isAnalysisDataFile(filename))	{
+		ProfiledStage stage("load");
+		AnalysisDataFile data(filename);
+		task.results = data.getInstanceResults();
+		task.analysed = true;
+		printMessage(clog, filename+": Analysis data were read!");
+		return;
+	}
+
+	if (manifest != NULL)
+		inputHash = ContentHash::hashFile(filename);
+
+	bool graphUpToDate = isUpToDate(graphFile);
+	bool resourceUtilizationUpToDate = isChartUpToDate(resourceUtilizationFile);
+	bool resourceUtilizationILPUpToDate = isChartUpToDate(resourceUtilizationILPFile);
+	bool statisticsUpToDate = isUpToDate(instanceStatisticsFile) && (!exportData || isUpToDate(analysisDataFile))
+		&& manifest->getResults(filename, inputHash, task.results);
+	if (graphUpToDate && resourceUtilizationUpToDate && resourceUtilizationILPUpToDate && statisticsUpToDate)	{
+		task.analysed = true;
+		printMessage(clog, filename+": All the outputs are up to date!");
+		return;
+	}
+
+	// The file is read and analysed only once, all the visualizers share the loaded instance.
+	ProfiledStage loadStage("load");
+	ScheduleInstance instance(filename);
+	loadStage.finish();
+
+	if (!graphUpToDate)	{
+		ProfiledStage stage("write "+graphFile);
+		VisualizerGraph graphVisualizer(instance);
+		graphVisualizer.writeInstanceGraph(graphFile, reducedGraph);
+		recordOutput(graphFile);
+		printMessage(clog, graphFile+": Instance graph was created!");
+	}
+
+	VisualizerResourceUtilization resourceUtilizationVisualizer(instance);
+	if (!resourceUtilizationUpToDate)	{
+		ProfiledStage stage("write "+resourceUtilizationFile);
+		resourceUtilizationVisualizer.writeResourceUtilization(resourceUtilizationFile, format);
+		vector<string> chartFiles = resourceUtilizationVisualizer.getChartFiles(resourceUtilizationFile);
+		recordOutputs(chartFiles);
+		printMessage(clog, joinFiles(chartFiles)+": Utilization of resources was computed and drawn!");
+	}
+
+	if (!resourceUtilizationILPUpToDate)	{
+		try {
+			ProfiledStage stage("write "+resourceUtilizationILPFile);
+			uint64_t criterion = resourceUtilizationVisualizer.writeResourceUtilizationILP(resourceUtilizationILPFile, pool, format, placer, cache);
+			vector<string> chartFiles = resourceUtilizationVisualizer.getChartFiles(resourceUtilizationILPFile);
+			recordOutputs(chartFiles);
+			stringstream message(stringstream::in | stringstream::out);
+			message<<joinFiles(chartFiles)<<": Blocks version of resources load was created (criterion "<<criterion<<")!";
+			printMessage(clog, message.str());
+		} catch (exception& e)	{
+			printMessage(cerr, resourceUtilizationFile+": "+e.what());
+		}
+	}
+
+	if (!statisticsUpToDate)	{
+		ProfiledStage closureStage("transitive closure");
+		VisualizerScheduleStatistics scheduleStatisticsVisualizer(instance);
+		closureStage.finish();
+
+		ProfiledStage stage("write "+instanceStatisticsFile);
+		scheduleStatisticsVisualizer.writeScheduleStatistics(instanceStatisticsFile, format);
+		task.results = scheduleStatisticsVisualizer.getScheduleAnalysisData();
+		if (manifest != NULL)
+			manifest->addResults(filename, inputHash, task.results);
+		recordOutput(instanceStatisticsFile);
+		printMessage(clog, instanceStatisticsFile+": Various parameters were analysed in the schedule order!");
+		stage.finish();
+
+		if (exportData)	{
+			ProfiledStage exportStage("write "+analysisDataFile);
+			scheduleStatisticsVisualizer.writeAnalysisData(analysisDataFile);
+			recordOutput(analysisDataFile);
+			printMessage(clog, analysisDataFile+": Analysis data were exported!");
+		}
+	}
+	task.analysed = true;
+}
+
+bool InstanceJob::isAnalysisDataFile(const string& file)	{
+	string suffix = ANALYSIS_DATA_SUFFIX;
+	return file.size() >= suffix.size() && file.compare(file.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool InstanceJob::isUpToDate(const string& output) const	{
+	return manifest != NULL && manifest->isUpToDate(task.filename, inputHash, output);
+}
+
+bool InstanceJob::isChartUpToDate(const string& chart) const	{
+	if (isUpToDate(chart))
+		return true;
+
+	// The chart of a long schedule is split into the tiles, all of them have to be up to date.
+	// The first tile which is not up to date must not have been generated at all, i.e. it is behind the last tile.
+	uint32_t tile = 1;
+	while (isUpToDate(VisualizerResourceUtilization::getTileFile(chart, tile)))
+		++tile;
+	return tile > 1 && !manifest->isRecorded(task.filename, inputHash, VisualizerResourceUtilization::getTileFile(chart, tile));
+}
+
+void InstanceJob::recordOutput(const string& output)	{
+	if (manifest != NULL)
+		manifest->addOutput(task.filename, inputHash, output);
+}
+
+void InstanceJob::recordOutputs(const vector<string>& outputs)	{
+	for (vector<string>::const_iterator it = outputs.begin(); it != outputs.end(); ++it)
+		recordOutput(*it);
+}
+
+string InstanceJob::joinFiles(const vector<string>& files)	{
+	string joinedFiles;
+	for (vector<string>::const_iterator it = files.begin(); it != files.end(); ++it)
+		joinedFiles += (it == files.begin() ? "" : ", ")+*it;
+	return joinedFiles;
+}
+
+/*
+ * All the parameters which influence the outputs, the incremental mode regenerates the outputs if they are changed.
+ * The number of threads, the cache, and the solver messages do not change the outputs.
+ */
+string getParametersDescription(FigureFormat format, BlocksPlacerType placer, bool reducedGraph)	{
+	stringstream description(stringstream::in | stringstream::out);
+	description.precision(17);
+	description<<"format "<<format<<"\nplacer "<<placer<<"\nreduced graph "<<reducedGraph<<"\n";
+	description<<ConfigureGraph::standardNodeColor<<"\n"<<ConfigureGraph::criticalNodeColor<<"\n"<<ConfigureGraph::startNodeColor<<"\n";
+	description<<ConfigureGraph::finishNodeColor<<"\n"<<ConfigureGraph::graphOrientation<<"\n";
+	description<<ConfigureResourceUtilization::blockColor<<"\n"<<ConfigureResourceUtilization::spaceBetweenResources<<"\n";
+	description<<ConfigureResourceUtilization::axisElongationX<<"\n"<<ConfigureResourceUtilization::axisElongationY<<"\n";
+	description<<ConfigureResourceUtilization::textDist<<"\n"<<ConfigureResourceUtilization::ticsLength<<"\n";
+	description<<ConfigureResourceUtilization::tileWidth<<"\n"<<ConfigureResourceUtilization::maxNumberOfTics<<"\n";
+	description<<ConfigureILPSolver::branchingTechnique<<"\n"<<ConfigureILPSolver::backtrackingTechnique<<"\n";
+	description<<ConfigureILPSolver::timeLimit<<"\n"<<ConfigureILPSolver::mipGap<<"\n";
+	description<<ConfigureScheduleAnalysis::boxSize<<"\n"<<ConfigureScheduleAnalysis::averageWindow<<"\n";
+	description<<ConfigureScheduleAnalysis::maxNumberOfColumns<<"\n"<<ConfigureScheduleAnalysis::maxNumberOfLabeledColumns<<"\n";
+	return description.str();
+}
+
+void printUsage()	{
+	cerr<<"Usage: RCPSPVisualizer [-t|--threads N] [-f|--format tikz|svg|pdf] [-p|--placer ilp|heuristic] [-c|--cache DIR] [-i|--incremental] [-x|--export] [-r|--reduce] [--profile FILE] result_file.res [result_file.res ...]"<<endl;
+	cerr<<"\t-t, --threads N\tnumber of concurrently processed files (0 ~ number of cores, default "<<ConfigureBatch::numberOfThreads<<")"<<endl;
+	cerr<<"\t-f, --format F\tformat of the figures, tikz ~ Latex sources, svg and pdf are written without Latex (default "<<figureExtension(ConfigureOutput::figureFormat)+1<<")"<<endl;
+	cerr<<"\t-p, --placer P\tplacement of the blocks, ilp ~ GLPK solver, heuristic ~ first-fit with the ILP fallback (default "
+		<<(ConfigureBlocksPlacement::placer == HEURISTIC_PLACER ? "heuristic" : "ilp")<<")"<<endl;
+	cerr<<"\t-c, --cache DIR\tdirectory of the cached ILP placements, the solver is not started for the cached resources"<<endl;
+	cerr<<"\t-i, --incremental\tonly the outputs of the changed files are generated, see the manifest "<<MANIFEST_FILE<<" in the output directory"<<endl;
+	cerr<<"\t-x, --export\tthe analysis data are written to the columnar binary files *"<<ANALYSIS_DATA_SUFFIX<<", the group statistics can be computed from them"<<endl;
+	cerr<<"\t-r, --reduce\tthe transitive arcs are omitted from the instance graphs and the activities are ranked by their levels"<<endl;
+	cerr<<"\t--profile FILE\tJSON report of the time, memory, and allocations of the processing stages of each file"<<endl;
+}
+
 int main(int argc, char* argv[])	{
 	cout<<"Copyright 2012, 2013, 2015 Libor Bukata and Premysl Sucha."<<endl;
 	cout<<"The program is distributed under the terms of the GNU General Public License."<<endl;
 	cout<<"RCPSP visualizer."<<endl<<endl;
 
-	string outputDirectory;
-	map<uint32_t, vector<InstanceResults> > analysisResults;
+	/* PARSE PROGRAM ARGUMENTS */
+	vector<string> inputFiles;
+	uint32_t numberOfThreads = ConfigureBatch::numberOfThreads;
+	FigureFormat format = ConfigureOutput::figureFormat;
+	BlocksPlacerType placer = ConfigureBlocksPlacement::placer;
+	string cacheDirectory = ConfigureBlocksPlacement::cacheDirectory;
+	bool incremental = false, exportData = false, reducedGraph = false;
+	string profileFile;
 	for (int i = 1; i < argc; ++i)	{
-		string filename = argv[i], baseName;
+		string argument = argv[i];
+		if (argument == "-t" || argument == "--threads")	{
+			char *end = NULL;
+			if (i+1 >= argc || (numberOfThreads = strtoul(argv[++i], &end, 10), *end != '\0'))	{
+				cerr<<"Invalid number of threads!"<<endl;
+				printUsage();
+				return 1;
+			}
+		} else if (argument == "-f" || argument == "--format")	{
+			string formatName = (i+1 < argc ? argv[++i] : "");
+			if (formatName == "tikz")	{
+				format = TIKZ_FORMAT;
+			} else if (formatName == "svg")	{
+				format = SVG_FORMAT;
+			} else if (formatName == "pdf")	{
+				format = PDF_FORMAT;
+			} else {
+				cerr<<"Invalid format of the figures!"<<endl;
+				printUsage();
+				return 1;
+			}
+		} else if (argument == "-p" || argument == "--placer")	{
+			string placerName = (i+1 < argc ? argv[++i] : "");
+			if (placerName == "ilp")	{
+				placer = ILP_PLACER;
+			} else if (placerName == "heuristic")	{
+				placer = HEURISTIC_PLACER;
+			} else {
+				cerr<<"Invalid placer of the blocks!"<<endl;
+				printUsage();
+				return 1;
+			}
+		} else if (argument == "-c" || argument == "--cache")	{
+			if (i+1 >= argc || (cacheDirectory = argv[++i]).empty())	{
+				cerr<<"Invalid cache directory!"<<endl;
+				printUsage();
+				return 1;
+			}
+		} else if (argument == "-i" || argument == "--incremental")	{
+			incremental = true;
+		} else if (argument == "-x" || argument == "--export")	{
+			exportData = true;
+		} else if (argument == "-r" || argument == "--reduce")	{
+			reducedGraph = true;
+		} else if (argument == "--profile")	{
+			if (i+1 >= argc || (profileFile = argv[++i]).empty())	{
+				cerr<<"Invalid profile file!"<<endl;
+				printUsage();
+				return 1;
+			}
+			Profiler::enable();
+		} else if (argument == "-h" || argument == "--help")	{
+			printUsage();
+			return 0;
+		} else {
+			inputFiles.push_back(argument);
+		}
+	}
+
+	if (numberOfThreads == 0)
+		numberOfThreads = WorkerPool::getNumberOfCores();
+
+	PlacementCache *cache = NULL;
+	if (!cacheDirectory.empty())	{
+		try {
+			cache = new PlacementCache(cacheDirectory);
+		} catch (exception& e)	{
+			cerr<<e.what()<<endl;
+			return 1;
+		}
+	}
+
+	/* PROCESS FILES */
+	string outputDirectory;
+	vector<InstanceTask> tasks(inputFiles.size());
+	for (uint32_t i = 0; i < inputFiles.size(); ++i)	{
+		string filename = inputFiles[i], baseName;
 		string::reverse_iterator dotIter = find(filename.rbegin(), filename.rend(), '.');
 		if (dotIter == filename.rend())	{
 			baseName = filename;
@@ -53,10 +441,6 @@ int main(int argc, char* argv[])	{
 			baseName = string(dotIter+1, filename.rend());
 			reverse(baseName.begin(), baseName.end());
 		}
-		string graphFile = baseName+"_GH.dot";
-		string resourceUtilizationFile = baseName+"_RU.tex";
-		string resourceUtilizationILPFile = baseName+"_RU_ILP.tex";
-		string instanceStatisticsFile = baseName+"_ST.tex";
 
 		uint32_t instanceParameter = 0;
 		for (uint32_t s = 0; s < baseName.size(); ++s)	{
@@ -68,42 +452,59 @@ int main(int argc, char* argv[])	{
 			}
 		}
 
-		string::iterator slashIter = find_if(filename.begin(), filename.end(), fileSystemSeperator);
-		if (slashIter != filename.end())
-			outputDirectory = string(filename.begin(), slashIter+1);
+		// The directory of the file, i.e. up to the last separator, e.g. "/tmp/x/a.res" -> "/tmp/x/".
+		string::reverse_iterator slashIter = find_if(filename.rbegin(), filename.rend(), fileSystemSeperator);
+		if (slashIter != filename.rend())
+			outputDirectory = string(filename.begin(), slashIter.base());
 
+		tasks[i].filename = filename;
+		tasks[i].baseName = baseName;
+		tasks[i].instanceParameter = instanceParameter;
+		tasks[i].analysed = false;
+	}
+
+	BatchManifest *manifest = NULL;
+	if (incremental)	{
 		try {
-			VisualizerGraph graphVisualizer(filename);
-			graphVisualizer.writeInstanceGraph(graphFile);
-			clog<<graphFile<<": Instance graph was created!"<<endl;
-
-			VisualizerResourceUtilization resourceUtilizationVisualizer(filename);
-			resourceUtilizationVisualizer.writeResourceUtilization(resourceUtilizationFile);
-			clog<<resourceUtilizationFile<<": Utilization of resources was computed and transformed to Latex source!"<<endl;
-			try {
-				resourceUtilizationVisualizer.writeResourceUtilizationILP(resourceUtilizationILPFile);
-				clog<<resourceUtilizationILPFile<<": Blocks version of resources load was created!"<<endl;
-			} catch (exception& e)	{
-				cerr<<resourceUtilizationFile<<": "<<e.what()<<endl;
-			}
+			ContentHash parametersHash;
+			parametersHash.update(getParametersDescription(format, placer, reducedGraph));
+			manifest = new BatchManifest(outputDirectory+MANIFEST_FILE, PROGRAM_VERSION, parametersHash.getHexValue());
+		} catch (exception& e)	{
+			cerr<<e.what()<<endl;
+			delete cache;
+			return 1;
+		}
+	}
 
-			VisualizerScheduleStatistics scheduleStatisticsVisualizer(filename);
-			scheduleStatisticsVisualizer.writeScheduleStatistics(instanceStatisticsFile);
-			analysisResults[instanceParameter].push_back(scheduleStatisticsVisualizer.getScheduleAnalysisData());
-			clog<<instanceStatisticsFile<<": Various parameters were analysed in the schedule order!"<<endl;
+	StatisticsCollector collector(tasks);
+	{
+		JobGroup instanceJobs;
+		WorkerPool pool(numberOfThreads);
+		for (vector<InstanceTask>::iterator it = tasks.begin(); it != tasks.end(); ++it)
+			pool.submit(new InstanceJob(*it, format, placer, exportData, reducedGraph, cache, manifest, collector, pool), instanceJobs);
+		pool.wait(instanceJobs);
+	}
+	delete cache;
 
+	if (manifest != NULL)	{
+		try {
+			manifest->compact();
 		} catch (exception& e)	{
 			cerr<<e.what()<<endl;
 		}
+		delete manifest;
 	}
 
-	vector<InstanceResults> allInstancesResults;
-	for (map<uint32_t, vector<InstanceResults> >::const_iterator mit = analysisResults.begin(); mit != analysisResults.end(); ++mit)	{
-		allInstancesResults.insert(allInstancesResults.end(), mit->second.begin(), mit->second.end());
+	// The complete statistics is merged from the statistics of the groups.
+	GroupStatistics allInstancesStatistics;
+	const map<uint32_t, GroupStatistics>& groups = collector.getGroups();
+	for (map<uint32_t, GroupStatistics>::const_iterator mit = groups.begin(); mit != groups.end(); ++mit)	{
+		allInstancesStatistics.merge(mit->second);
 		try	{
 			stringstream line(stringstream::in | stringstream::out);
-			line<<outputDirectory<<"stat_"<<mit->first<<".tex";
-			VisualizerScheduleStatistics::writeGroupStatistics(line.str(), mit->second);
+			line<<outputDirectory<<"stat_"<<mit->first<<figureExtension(format);
+			ProfiledStage stage("write "+line.str());
+			VisualizerScheduleStatistics::writeGroupStatistics(line.str(), mit->second, format);
 			clog<<line.str()<<": Group statistics was written!"<<endl;
 		} catch (exception& e)	{
 			cerr<<e.what()<<endl;
@@ -111,12 +512,22 @@ int main(int argc, char* argv[])	{
 	}
 
 	try {
-		string file = outputDirectory+"complete_stat.tex";
-		VisualizerScheduleStatistics::writeGroupStatistics(file, allInstancesResults);
+		string file = outputDirectory+"complete_stat"+figureExtension(format);
+		ProfiledStage stage("write "+file);
+		VisualizerScheduleStatistics::writeGroupStatistics(file, allInstancesStatistics, format);
 		clog<<file<<": Complete statistics of all read instances was written!"<<endl;
 	} catch (exception& e)	{
 		cerr<<e.what()<<endl;
 	}
 
+	if (!profileFile.empty())	{
+		try {
+			Profiler::writeReport(profileFile);
+			clog<<profileFile<<": Profile of the processing stages was written!"<<endl;
+		} catch (exception& e)	{
+			cerr<<e.what()<<endl;
+		}
+	}
+
 	return 0;
 }
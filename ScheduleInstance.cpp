@@ -0,0 +1,330 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "ScheduleInstance.h"
+
+#ifdef __GNUC__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+ScheduleInstance::ScheduleInstance(const string& fileName)	: mappedFile(NULL), mappedSize(0),
+	numberOfActivities(0), numberOfResources(0) {
+
+	if (!mapFile(fileName))
+		throw invalid_argument("ScheduleInstance::ScheduleInstance(const string&): Cannot open the input file!");
+
+	// The whole file is validated before any array is used.
+	int32_t phase = setInputViews();
+	if (phase == -1)	{
+		/* COMPRESSED SPARSE ROW INDICES AND ANALYSIS ARRAYS */
+		arena.resize(5*((size_t) numberOfActivities)+2);
+		successorsIndex = &arena[0];
+		predecessorsIndex = &arena[numberOfActivities+1];
+		topologicalOrder = &arena[2*numberOfActivities+2];
+		earliestStartTimes = &arena[3*numberOfActivities+2];
+		latestStartTimes = &arena[4*numberOfActivities+2];
+		buildIndex(numberOfSuccessors, successorsIndex);
+		buildIndex(numberOfPredecessors, predecessorsIndex);
+
+		// It computes earliest and latest start times of activities by the forward and backward pass.
+		if (!computeCriticalPath())
+			phase = 12;
+	}
+
+	if (phase != -1)	{
+		unmapFile();
+		throw runtime_error("ScheduleInstance::ScheduleInstance(const string&): "+getErrorMessage(phase));
+	}
+}
+
+ScheduleInstance::~ScheduleInstance()	{
+	unmapFile();
+}
+
+vector<int32_t> ScheduleInstance::getDistanceMatrix() const	{
+	// Row i holds the longest paths from activity i, -1 means that the activity is not reachable.
+	vector<int32_t> distanceMatrix(numberOfActivities*numberOfActivities, -1);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		int32_t *distance = &distanceMatrix[i*numberOfActivities];
+		distance[i] = 0;
+		for (uint32_t k = 0; k < numberOfActivities; ++k)	{
+			uint32_t activityId = topologicalOrder[k];
+			if (distance[activityId] == -1)
+				continue;
+
+			int32_t pathLength = distance[activityId]+activitiesDuration[activityId];
+			for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)	{
+				uint32_t successorId = successors[j];
+				if (pathLength > distance[successorId])
+					distance[successorId] = pathLength;
+			}
+		}
+	}
+
+	return distanceMatrix;
+}
+
+bool ScheduleInstance::computeCriticalPath()	{
+	/* TOPOLOGICAL ORDER (KAHN'S ALGORITHM) */
+	vector<uint32_t> inDegree(numberOfActivities, 0);
+	for (uint32_t j = 0; j < successorsIndex[numberOfActivities]; ++j)
+		++inDegree[successors[j]];
+
+	uint32_t head = 0, tail = 0;
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		if (inDegree[i] == 0)
+			topologicalOrder[tail++] = i;
+	}
+
+	while (head < tail)	{
+		uint32_t activityId = topologicalOrder[head++];
+		for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)	{
+			uint32_t successorId = successors[j];
+			if (--inDegree[successorId] == 0)
+				topologicalOrder[tail++] = successorId;
+		}
+	}
+
+	if (tail != numberOfActivities)
+		return false;
+
+	/* FORWARD PASS - HEAD LENGTHS */
+	fill(earliestStartTimes, earliestStartTimes+numberOfActivities, 0);
+	for (uint32_t k = 0; k < numberOfActivities; ++k)	{
+		uint32_t activityId = topologicalOrder[k];
+		uint32_t finishTime = earliestStartTimes[activityId]+activitiesDuration[activityId];
+		for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)	{
+			uint32_t successorId = successors[j];
+			earliestStartTimes[successorId] = max(earliestStartTimes[successorId], finishTime);
+		}
+	}
+
+	/* BACKWARD PASS - TAIL LENGTHS */
+	criticalPathLength = earliestStartTimes[numberOfActivities-1];
+	for (uint32_t k = numberOfActivities; k > 0; --k)	{
+		uint32_t activityId = topologicalOrder[k-1];
+		uint32_t latestFinishTime = criticalPathLength;
+		for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)
+			latestFinishTime = min(latestFinishTime, latestStartTimes[successors[j]]);
+		latestStartTimes[activityId] = latestFinishTime-min(latestFinishTime, activitiesDuration[activityId]);
+	}
+
+	return true;
+}
+
+bool ScheduleInstance::mapFile(const string& fileName)	{
+	#ifdef __GNUC__
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat fileStatus;
+	if (fstat(fd, &fileStatus) == -1 || !S_ISREG(fileStatus.st_mode))	{
+		close(fd);
+		return false;
+	}
+
+	mappedSize = fileStatus.st_size;
+	if (mappedSize > 0)	{
+		// The mapping is kept after the file descriptor is closed.
+		void *mapping = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED)	{
+			close(fd);
+			return false;
+		}
+		mappedFile = mapping;
+	}
+	close(fd);
+	#else
+	ifstream input(fileName.c_str(), ios::in | ios::binary);
+	if (!input.good())
+		return false;
+
+	input.seekg(0, ios::end);
+	mappedSize = input.tellg();
+	input.seekg(0, ios::beg);
+	fileContent.resize(mappedSize/sizeof(uint32_t)+1);
+	if (mappedSize > 0 && input.read((char*) &fileContent[0], mappedSize).fail())
+		return false;
+	mappedFile = &fileContent[0];
+	#endif
+
+	return true;
+}
+
+void ScheduleInstance::unmapFile()	{
+	#ifdef __GNUC__
+	if (mappedFile != NULL)
+		munmap(mappedFile, mappedSize);
+	#endif
+	mappedFile = NULL;
+	mappedSize = 0;
+}
+
+int32_t ScheduleInstance::setInputViews()	{
+	const uint32_t *words = (const uint32_t*) mappedFile;
+	size_t numberOfWords = mappedSize/sizeof(uint32_t), position = 0;
+	bool wholeWords = (mappedSize % sizeof(uint32_t) == 0);
+
+	/* LAYOUT OF THE FILE (COUNTS AND SIZES) */
+	if (!takeArray(words, numberOfWords, position, 1, numberOfActivities) || numberOfActivities <= 2)
+		return 0;
+	if (!takeArray(words, numberOfWords, position, 1, numberOfResources) || numberOfResources < 1)
+		return 1;
+
+	uint64_t numberOfRequirements = ((uint64_t) numberOfActivities)*numberOfResources;
+	if (!takeArray(words, numberOfWords, position, numberOfActivities, activitiesDuration))
+		return 2;
+	if (!takeArray(words, numberOfWords, position, numberOfResources, resourceCapacities))
+		return 3;
+	if (!takeArray(words, numberOfWords, position, numberOfRequirements, requiredResources))
+		return 4;
+	if (!takeArray(words, numberOfWords, position, numberOfActivities, numberOfSuccessors))
+		return 5;
+	uint64_t numberOfArcs = sumOfArray(numberOfSuccessors, numberOfActivities);
+	if (!takeArray(words, numberOfWords, position, numberOfArcs, successors))
+		return 6;
+	if (!takeArray(words, numberOfWords, position, numberOfActivities, numberOfPredecessors))
+		return 7;
+	if (!takeArray(words, numberOfWords, position, sumOfArray(numberOfPredecessors, numberOfActivities), predecessors))
+		return 8;
+	if (!takeArray(words, numberOfWords, position, 1, projectMakespan))
+		return 9;
+	if (!takeArray(words, numberOfWords, position, numberOfActivities, scheduleOrder))
+		return 10;
+	if (!takeArray(words, numberOfWords, position, numberOfActivities, startTimesById))
+		return 11;
+	if (position != numberOfWords || !wholeWords)
+		return 13;
+
+	/* VALUES */
+	for (uint32_t r = 0; r < numberOfResources; ++r)	{
+		if (resourceCapacities[r] == 0)
+			return 14;
+	}
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		for (uint32_t r = 0; r < numberOfResources; ++r)	{
+			if (requiredResources[i*numberOfResources+r] > resourceCapacities[r])
+				return 15;
+		}
+	}
+	if (!validIds(successors, numberOfArcs))
+		return 16;
+	if (sumOfArray(numberOfPredecessors, numberOfActivities) != numberOfArcs)
+		return 18;
+	if (!validIds(predecessors, numberOfArcs))
+		return 17;
+	if (!validIds(scheduleOrder, numberOfActivities))
+		return 19;
+	if (!isPermutation(scheduleOrder))
+		return 20;
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		// The activities have to finish before the makespan, i.e. the sum cannot overflow either.
+		if (activitiesDuration[i] > projectMakespan || startTimesById[i] > projectMakespan-activitiesDuration[i])
+			return 21;
+	}
+
+	return -1;
+}
+
+bool ScheduleInstance::takeArray(const uint32_t *words, size_t numberOfWords, size_t& position, uint64_t numberOfElements, const uint32_t*& array)	{
+	if (numberOfElements > numberOfWords-position)
+		return false;
+	array = words+position;
+	position += numberOfElements;
+	return true;
+}
+
+bool ScheduleInstance::takeArray(const uint32_t *words, size_t numberOfWords, size_t& position, uint64_t numberOfElements, uint32_t& value)	{
+	const uint32_t *array = NULL;
+	if (!takeArray(words, numberOfWords, position, numberOfElements, array))
+		return false;
+	value = *array;
+	return true;
+}
+
+uint64_t ScheduleInstance::sumOfArray(const uint32_t *array, size_t numberOfElements)	{
+	uint64_t sum = 0;
+	for (size_t i = 0; i < numberOfElements; ++i)
+		sum += array[i];
+	return sum;
+}
+
+bool ScheduleInstance::validIds(const uint32_t *ids, size_t numberOfElements) const	{
+	for (size_t i = 0; i < numberOfElements; ++i)	{
+		if (ids[i] >= numberOfActivities)
+			return false;
+	}
+	return true;
+}
+
+bool ScheduleInstance::isPermutation(const uint32_t *ids) const	{
+	// The ids have to be valid, each activity has to be present exactly once.
+	vector<bool> present(numberOfActivities, false);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		if (present[ids[i]])
+			return false;
+		present[ids[i]] = true;
+	}
+	return true;
+}
+
+void ScheduleInstance::buildIndex(const uint32_t *numberOfRelated, uint32_t *index) const	{
+	index[0] = 0;
+	for (uint32_t i = 0; i < numberOfActivities; ++i)
+		index[i+1] = index[i]+numberOfRelated[i];
+}
+
+string ScheduleInstance::getErrorMessage(const int32_t& phase)	{
+	string errorMessage;
+	switch (phase)	{
+		case 0: errorMessage = "Cannot read variable 'numberOfActivities'!"; break;
+		case 1: errorMessage = "Error while reading number of resources!"; break;
+		case 2: errorMessage = "Unexpected error while reading array of activity durations!"; break;
+		case 3: errorMessage = "The resource capacities is impossible to read from the input file!"; break;
+		case 4: errorMessage = "Unexpected error while reading two-dimensional array of activities resource requirements!"; break;
+		case 5: errorMessage = "Error while reading number of successors for each activity!"; break;
+		case 6: errorMessage = "Cannot retrieve successors from the input file!"; break;
+		case 7: errorMessage = "Error while reading number of predecessors for each activity!"; break;
+		case 8: errorMessage = "Cannot retrieve predecessors from the input file!"; break;
+		case 9: errorMessage = "Cannot read the project makespan!"; break;
+		case 10: errorMessage = "Unexpected error while reading schedule order!"; break;
+		case 11: errorMessage = "Cannot read the array of scheduled start time values!"; break;
+		case 12: errorMessage = "The precedence graph contains a cycle!"; break;
+		case 13: errorMessage = "The size of the input file does not correspond to the stored counts!"; break;
+		case 14: errorMessage = "The resource capacities have to be positive!"; break;
+		case 15: errorMessage = "An activity requires more than the capacity of a resource!"; break;
+		case 16: errorMessage = "Invalid activity id in the successors!"; break;
+		case 17: errorMessage = "Invalid activity id in the predecessors!"; break;
+		case 18: errorMessage = "The numbers of successors and predecessors are inconsistent!"; break;
+		case 19: errorMessage = "Invalid activity id in the schedule order!"; break;
+		case 20: errorMessage = "The schedule order is not a permutation of the activities!"; break;
+		case 21: errorMessage = "An activity finishes after the project makespan!"; break;
+
+		default: errorMessage = "No errors.";
+	}
+
+	return errorMessage;
+}
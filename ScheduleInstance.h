@@ -0,0 +1,93 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SCHEDULE_INSTANCE_H
+#define SCHEDULE_INSTANCE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/*
+ * Instance and schedule read from one binary result file. The data are loaded and analysed
+ * only once and then shared (read-only) by all visualizers that render the same file.
+ * The file is memory mapped and validated up front, the arrays stored in the file are
+ * read-only views of the mapping (no copying). The requirements are stored row-major
+ * (activity x resource). The successors/predecessors are used in the compressed sparse row format,
+ * e.g. the successors of activity i are successors[successorsIndex[i]], ..., successors[successorsIndex[i+1]-1],
+ * the indices and the results of the analysis live in one contiguous arena.
+ */
+class ScheduleInstance {
+
+	friend class Visualizer;
+
+	public:
+
+		ScheduleInstance(const std::string& fileName);
+		~ScheduleInstance();
+
+		// All-pairs longest paths (row-major, -1 ~ unreachable), it is computed on demand in O(n*(n+m)).
+		std::vector<int32_t> getDistanceMatrix() const;
+
+	private:
+
+		// The views point to the own mapping and arena, copying is forbidden.
+		ScheduleInstance(const ScheduleInstance&);
+		ScheduleInstance& operator=(const ScheduleInstance&);
+
+		bool mapFile(const std::string& fileName);
+		void unmapFile();
+		int32_t setInputViews();
+		static bool takeArray(const uint32_t *words, size_t numberOfWords, size_t& position, uint64_t numberOfElements, const uint32_t*& array);
+		static bool takeArray(const uint32_t *words, size_t numberOfWords, size_t& position, uint64_t numberOfElements, uint32_t& value);
+		static uint64_t sumOfArray(const uint32_t *array, size_t numberOfElements);
+		bool validIds(const uint32_t *ids, size_t numberOfElements) const;
+		bool isPermutation(const uint32_t *ids) const;
+		void buildIndex(const uint32_t *numberOfRelated, uint32_t *index) const;
+		bool computeCriticalPath();
+		static std::string getErrorMessage(const int32_t& phase);
+
+		void *mappedFile;
+		size_t mappedSize;
+		#ifndef __GNUC__
+		std::vector<uint32_t> fileContent;
+		#endif
+		std::vector<uint32_t> arena;
+
+		uint32_t numberOfActivities;
+		uint32_t numberOfResources;
+		const uint32_t *activitiesDuration;
+		const uint32_t *resourceCapacities;
+		const uint32_t *requiredResources;
+		const uint32_t *numberOfSuccessors;
+		const uint32_t *numberOfPredecessors;
+		uint32_t *successorsIndex;
+		const uint32_t *successors;
+		uint32_t *predecessorsIndex;
+		const uint32_t *predecessors;
+
+		uint32_t projectMakespan;
+		const uint32_t *scheduleOrder;
+		const uint32_t *startTimesById;
+
+		uint32_t criticalPathLength;
+		uint32_t *topologicalOrder;
+		uint32_t *earliestStartTimes;
+		uint32_t *latestStartTimes;
+};
+
+#endif
+
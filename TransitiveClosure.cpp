@@ -0,0 +1,86 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <vector>
+#include "TransitiveClosure.h"
+
+using namespace std;
+
+#ifdef __GNUC__
+#define POPCOUNT64(x) __builtin_popcountll(x)
+#define CTZ64(x) __builtin_ctzll(x)
+#define RESTRICT __restrict__
+#else
+#define RESTRICT
+static inline uint32_t POPCOUNT64(uint64_t x)	{
+	uint32_t count = 0;
+	for (; x != 0; x &= x-1)
+		++count;
+	return count;
+}
+static inline uint32_t CTZ64(uint64_t x)	{
+	uint32_t count = 0;
+	for (; (x & 1) == 0; x >>= 1)
+		++count;
+	return count;
+}
+#endif
+
+TransitiveClosure::TransitiveClosure(uint32_t numberOfActivities, const uint32_t *relatedIndex, const uint32_t *related,
+		const uint32_t *topologicalOrder, bool reversedOrder) : numberOfActivities(numberOfActivities) {
+
+	numberOfWords = (numberOfActivities+63)/64;
+	bits.resize(((size_t) numberOfActivities)*numberOfWords, 0);
+
+	for (uint32_t k = 0; k < numberOfActivities; ++k)	{
+		uint32_t activityId = (reversedOrder ? topologicalOrder[numberOfActivities-k-1] : topologicalOrder[k]);
+		uint64_t * RESTRICT row = &bits[((size_t) activityId)*numberOfWords];
+		for (uint32_t j = relatedIndex[activityId]; j < relatedIndex[activityId+1]; ++j)	{
+			uint32_t relatedId = related[j];
+			const uint64_t * RESTRICT relatedRow = &bits[((size_t) relatedId)*numberOfWords];
+			// Plain loop over the words, the compiler vectorizes it.
+			for (uint32_t w = 0; w < numberOfWords; ++w)
+				row[w] |= relatedRow[w];
+			row[relatedId/64] |= ((uint64_t) 1) << (relatedId % 64);
+		}
+	}
+}
+
+bool TransitiveClosure::isRelated(uint32_t activityId, uint32_t relatedId) const	{
+	return (bits[((size_t) activityId)*numberOfWords+relatedId/64] >> (relatedId % 64)) & 1;
+}
+
+uint32_t TransitiveClosure::getNumberOfRelated(uint32_t activityId) const	{
+	uint32_t numberOfRelated = 0;
+	const uint64_t *row = &bits[((size_t) activityId)*numberOfWords];
+	for (uint32_t w = 0; w < numberOfWords; ++w)
+		numberOfRelated += POPCOUNT64(row[w]);
+	return numberOfRelated;
+}
+
+uint32_t TransitiveClosure::getSumOfRelated(uint32_t activityId, const uint32_t *weights) const	{
+	uint32_t sumOfWeights = 0;
+	const uint64_t *row = &bits[((size_t) activityId)*numberOfWords];
+	for (uint32_t w = 0; w < numberOfWords; ++w)	{
+		for (uint64_t word = row[w]; word != 0; word &= word-1)
+			sumOfWeights += weights[64*w+CTZ64(word)];
+	}
+	return sumOfWeights;
+}
+
+const uint64_t* TransitiveClosure::getRow(uint32_t activityId) const	{
+	return &bits[((size_t) activityId)*numberOfWords];
+}
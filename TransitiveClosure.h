@@ -0,0 +1,53 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef TRANSITIVE_CLOSURE_H
+#define TRANSITIVE_CLOSURE_H
+
+#include <vector>
+#include <stdint.h>
+
+/*
+ * Transitive closure of the precedence relation stored as one bitset row per activity.
+ * The rows are computed in a topological order by the word-parallel OR of the related rows.
+ */
+class TransitiveClosure {
+	public:
+
+		/*
+		 * The related activities (e.g. successors) are given in the compressed sparse row format and they have to be processed before the activity itself,
+		 * i.e. the successors closure is computed in the reversed topological order.
+		 */
+		TransitiveClosure(uint32_t numberOfActivities, const uint32_t *relatedIndex, const uint32_t *related,
+				const uint32_t *topologicalOrder, bool reversedOrder);
+
+		bool isRelated(uint32_t activityId, uint32_t relatedId) const;
+		uint32_t getNumberOfRelated(uint32_t activityId) const;
+		uint32_t getSumOfRelated(uint32_t activityId, const uint32_t *weights) const;
+
+		// The bitset row of the activity, bit k of word k/64 is set if activity k is related.
+		const uint64_t* getRow(uint32_t activityId) const;
+		uint32_t getNumberOfWords() const { return numberOfWords; }
+
+	private:
+
+		uint32_t numberOfActivities;
+		uint32_t numberOfWords;
+		std::vector<uint64_t> bits;
+};
+
+#endif
+
@@ -0,0 +1,316 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "VectorCanvas.h"
+
+using namespace std;
+
+// Points per centimeter, the TikZ coordinates are in centimeters.
+#define POINTS_PER_CM 28.3464567
+// Width of the reserved SVG attributes with the page size.
+#define SVG_RESERVED_SIZE 128
+// Margin around the bounding box of the figure in points.
+#define PAGE_MARGIN 5.0
+
+struct NamedColor	{
+	const char* name;
+	RGBColor color;
+};
+
+// The RGB equivalents of the xcolor names used by the figures (dvipsnames are converted from CMYK).
+static const NamedColor namedColors[] = {
+	{ "white", { 1, 1, 1 } }, { "White", { 1, 1, 1 } }, { "black", { 0, 0, 0 } }, { "Black", { 0, 0, 0 } },
+	{ "red", { 1, 0, 0 } }, { "green", { 0, 1, 0 } }, { "blue", { 0, 0, 1 } }, { "cyan", { 0, 1, 1 } },
+	{ "magenta", { 1, 0, 1 } }, { "yellow", { 1, 1, 0 } }, { "gray", { 0.5, 0.5, 0.5 } }, { "orange", { 1, 0.5, 0 } },
+	{ "Brown", { 0.4, 0.076, 0 } }, { "Apricot", { 1, 0.68, 0.48 } }, { "Orange", { 1, 0.39, 0.13 } },
+	{ "Violet", { 0.21, 0.12, 1 } }, { "JungleGreen", { 0.01, 1, 0.48 } }, { "Aquamarine", { 0.18, 1, 0.7 } },
+	{ "LimeGreen", { 0.5, 1, 0 } }, { "CarnationPink", { 1, 0.37, 1 } }, { "Purple", { 0.55, 0.14, 1 } }
+};
+
+// Advance widths of the Helvetica-Bold characters 32-126 in thousandths of the font size.
+static const uint16_t characterWidths[95] = {
+	278, 333, 474, 556, 556, 889, 722, 278, 333, 333, 389, 584, 278, 333, 278, 278,
+	556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611,
+	975, 722, 722, 722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778,
+	667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 333, 278, 333, 584, 556,
+	278, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278, 889, 611, 611,
+	611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584
+};
+
+VectorCanvas::VectorCanvas(const string& file, FigureFormat format, double scale) : output(file), format(format),
+	unit(scale*POINTS_PER_CM), minX(DBL_MAX), minY(DBL_MAX), maxX(-DBL_MAX), maxY(-DBL_MAX), reservedPosition(0)	{
+	if (format == SVG_FORMAT)	{
+		output<<"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		output<<"<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" ";
+		// The page size is known after the figure is drawn.
+		reservedPosition = output.getPosition();
+		output<<string(SVG_RESERVED_SIZE, ' ')<<">\n";
+		output<<"<g font-family=\"Helvetica, Arial, sans-serif\" stroke-linecap=\"butt\">\n";
+	} else if (format == PDF_FORMAT)	{
+		objectOffsets.resize(8, 0);
+		output<<"%PDF-1.4\n";
+		objectOffsets[1] = output.getPosition();
+		output<<"1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+		objectOffsets[3] = output.getPosition();
+		output<<"3 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica-Bold /Encoding /WinAnsiEncoding >>\nendobj\n";
+		objectOffsets[4] = output.getPosition();
+		output<<"4 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica /Encoding /WinAnsiEncoding >>\nendobj\n";
+		// The length of the content stream is an indirect object written after the stream.
+		objectOffsets[5] = output.getPosition();
+		output<<"5 0 obj\n<< /Length 6 0 R >>\nstream\n";
+		reservedPosition = output.getPosition();
+	} else {
+		throw invalid_argument("VectorCanvas::VectorCanvas: Only SVG and PDF formats can be drawn directly!");
+	}
+}
+
+void VectorCanvas::drawRectangle(double x1, double y1, double x2, double y2, const RGBColor& fill, double lineWidth)	{
+	double left = min(x1, x2)*unit, right = max(x1, x2)*unit;
+	double bottom = min(y1, y2)*unit, top = max(y1, y2)*unit;
+	extendBoundingBox(left-lineWidth/2., bottom-lineWidth/2.);
+	extendBoundingBox(right+lineWidth/2., top+lineWidth/2.);
+
+	if (format == SVG_FORMAT)	{
+		output<<"<rect x=\""; writeCoordinate(left);
+		output<<"\" y=\""; writeCoordinate(-top);
+		output<<"\" width=\""; writeCoordinate(right-left);
+		output<<"\" height=\""; writeCoordinate(top-bottom);
+		output<<"\" fill=\""; writeColor(fill, false);
+		output<<"\" stroke=\"#000000\" stroke-width=\""; writeCoordinate(lineWidth);
+		output<<"\"/>\n";
+	} else {
+		writeColor(fill, false);
+		output<<" 0 G "; writeCoordinate(lineWidth);
+		output<<" w "; writePoint(left, bottom);
+		output<<' '; writePoint(right-left, top-bottom);
+		output<<" re B\n";
+	}
+}
+
+void VectorCanvas::drawLine(double x1, double y1, double x2, double y2, const RGBColor& color, double lineWidth, bool dashed, bool arrow)	{
+	double ax = x1*unit, ay = y1*unit, bx = x2*unit, by = y2*unit;
+	double length = sqrt((bx-ax)*(bx-ax)+(by-ay)*(by-ay));
+
+	// The triangle arrow head (TikZ "triangle 45") is drawn at the end point, the line ends at its base.
+	double headLength = 3*lineWidth+3.5, headHalfWidth = 0.414*headLength;
+	double ex = bx, ey = by, ux = 0, uy = 0;
+	if (arrow && length > headLength)	{
+		ux = (bx-ax)/length; uy = (by-ay)/length;
+		ex = bx-ux*headLength; ey = by-uy*headLength;
+	} else {
+		arrow = false;
+	}
+
+	extendBoundingBox(ax, ay);
+	extendBoundingBox(bx, by);
+
+	if (format == SVG_FORMAT)	{
+		output<<"<line x1=\""; writeCoordinate(ax);
+		output<<"\" y1=\""; writeCoordinate(-ay);
+		output<<"\" x2=\""; writeCoordinate(ex);
+		output<<"\" y2=\""; writeCoordinate(-ey);
+		output<<"\" stroke=\""; writeColor(color, true);
+		output<<"\" stroke-width=\""; writeCoordinate(lineWidth);
+		if (dashed)
+			output<<"\" stroke-dasharray=\"3,3";
+		output<<"\"/>\n";
+		if (arrow)	{
+			output<<"<polygon points=\"";
+			writeCoordinate(bx); output<<','; writeCoordinate(-by); output<<' ';
+			writeCoordinate(ex-uy*headHalfWidth); output<<','; writeCoordinate(-(ey+ux*headHalfWidth)); output<<' ';
+			writeCoordinate(ex+uy*headHalfWidth); output<<','; writeCoordinate(-(ey-ux*headHalfWidth));
+			output<<"\" fill=\""; writeColor(color, false);
+			output<<"\"/>\n";
+		}
+	} else {
+		writeColor(color, true);
+		output<<' '; writeCoordinate(lineWidth);
+		output<<(dashed ? " w [3 3] 0 d " : " w ");
+		writePoint(ax, ay); output<<" m ";
+		writePoint(ex, ey); output<<" l S";
+		if (dashed)
+			output<<" [] 0 d";
+		output<<"\n";
+		if (arrow)	{
+			writeColor(color, false);
+			output<<' '; writePoint(bx, by);
+			output<<" m "; writePoint(ex-uy*headHalfWidth, ey+ux*headHalfWidth);
+			output<<" l "; writePoint(ex+uy*headHalfWidth, ey-ux*headHalfWidth);
+			output<<" l f\n";
+		}
+	}
+}
+
+void VectorCanvas::drawText(double x, double y, const string& text, double fontSize, bool bold, TextPlacement placement, double distance)	{
+	// The text is placed as the TikZ node with the default inner separation.
+	double width = getTextWidth(text, fontSize, bold), separation = fontSize/3.+distance;
+	double left = x*unit-width/2., baseline = y*unit-0.35*fontSize;
+	switch (placement)	{
+		case TEXT_LEFT:
+			left = x*unit-width-separation;
+			break;
+		case TEXT_ABOVE:
+			baseline = y*unit+separation+0.25*fontSize;
+			break;
+		case TEXT_BELOW:
+			baseline = y*unit-separation-0.75*fontSize;
+			break;
+		default:
+			break;
+	}
+
+	extendBoundingBox(left, baseline-0.25*fontSize);
+	extendBoundingBox(left+width, baseline+0.75*fontSize);
+
+	string escapedText = escapeText(text, format);
+	if (format == SVG_FORMAT)	{
+		output<<"<text x=\""; writeCoordinate(left);
+		output<<"\" y=\""; writeCoordinate(-baseline);
+		output<<"\" font-size=\""; writeCoordinate(fontSize);
+		output<<(bold ? "\" font-weight=\"bold\">" : "\">")<<escapedText<<"</text>\n";
+	} else {
+		output<<"0 g BT "<<(bold ? "/F1 " : "/F2 ");
+		writeCoordinate(fontSize);
+		output<<" Tf "; writePoint(left, baseline);
+		output<<" Td ("<<escapedText<<") Tj ET\n";
+	}
+}
+
+void VectorCanvas::close()	{
+	if (minX > maxX)	{
+		// Nothing was drawn.
+		minX = minY = maxX = maxY = 0;
+	}
+
+	double left = floor(minX-PAGE_MARGIN), bottom = floor(minY-PAGE_MARGIN);
+	double width = ceil(maxX+PAGE_MARGIN)-left, height = ceil(maxY+PAGE_MARGIN)-bottom;
+
+	char pageSize[SVG_RESERVED_SIZE+1];
+	if (format == SVG_FORMAT)	{
+		output<<"</g>\n</svg>\n";
+		int length = snprintf(pageSize, sizeof(pageSize), "width=\"%.0fpt\" height=\"%.0fpt\" viewBox=\"%.0f %.0f %.0f %.0f\"",
+				width, height, left, -(bottom+height), width, height);
+		if (length < 0 || length > SVG_RESERVED_SIZE)
+			throw runtime_error("VectorCanvas::close: The size of the figure is out of range!");
+		output.overwrite(reservedPosition, pageSize, length);
+	} else {
+		uint64_t streamLength = output.getPosition()-reservedPosition;
+		output<<"endstream\nendobj\n";
+		objectOffsets[6] = output.getPosition();
+		output<<"6 0 obj\n"<<streamLength<<"\nendobj\n";
+		objectOffsets[2] = output.getPosition();
+		output<<"2 0 obj\n<< /Type /Pages /Kids [7 0 R] /Count 1 >>\nendobj\n";
+		objectOffsets[7] = output.getPosition();
+		snprintf(pageSize, sizeof(pageSize), "[%.0f %.0f %.0f %.0f]", left, bottom, left+width, bottom+height);
+		output<<"7 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox "<<pageSize;
+		output<<" /Resources << /Font << /F1 3 0 R /F2 4 0 R >> >> /Contents 5 0 R >>\nendobj\n";
+
+		uint64_t xrefPosition = output.getPosition();
+		output<<"xref\n0 "<<(uint32_t) objectOffsets.size()<<"\n";
+		output<<"0000000000 65535 f \n";
+		for (uint32_t i = 1; i < objectOffsets.size(); ++i)	{
+			char entry[32];
+			int length = snprintf(entry, sizeof(entry), "%010llu 00000 n \n", (unsigned long long) objectOffsets[i]);
+			output.write(entry, length);
+		}
+		output<<"trailer\n<< /Size "<<(uint32_t) objectOffsets.size()<<" /Root 1 0 R >>\n";
+		output<<"startxref\n"<<xrefPosition<<"\n%%EOF\n";
+	}
+
+	output.close();
+}
+
+RGBColor VectorCanvas::getColor(const char* name, double tint)	{
+	// Unknown names are drawn gray, the TikZ figures accept any color defined in Latex.
+	RGBColor color = { 0.5, 0.5, 0.5 };
+	for (uint32_t i = 0; i < sizeof(namedColors)/sizeof(namedColors[0]); ++i)	{
+		if (strcmp(namedColors[i].name, name) == 0)	{
+			color = namedColors[i].color;
+			break;
+		}
+	}
+
+	double ratio = max(0., min(tint, 100.))/100.;
+	color.red = ratio*color.red+(1-ratio);
+	color.green = ratio*color.green+(1-ratio);
+	color.blue = ratio*color.blue+(1-ratio);
+	return color;
+}
+
+void VectorCanvas::writeCoordinate(double value)	{
+	output.writeFixed(value, 2);
+}
+
+void VectorCanvas::writePoint(double x, double y)	{
+	writeCoordinate(x);
+	output<<' ';
+	writeCoordinate(y);
+}
+
+void VectorCanvas::writeColor(const RGBColor& color, bool stroke)	{
+	if (format == SVG_FORMAT)	{
+		char hexColor[8];
+		snprintf(hexColor, sizeof(hexColor), "#%02x%02x%02x", (uint32_t) floor(255*color.red+0.5),
+				(uint32_t) floor(255*color.green+0.5), (uint32_t) floor(255*color.blue+0.5));
+		output<<hexColor;
+	} else {
+		output.writeFixed(color.red, 3)<<' ';
+		output.writeFixed(color.green, 3)<<' ';
+		output.writeFixed(color.blue, 3)<<(stroke ? " RG" : " rg");
+	}
+}
+
+void VectorCanvas::extendBoundingBox(double x, double y)	{
+	minX = min(minX, x); maxX = max(maxX, x);
+	minY = min(minY, y); maxY = max(maxY, y);
+}
+
+double VectorCanvas::getTextWidth(const string& text, double fontSize, bool bold)	{
+	double width = 0;
+	for (string::const_iterator it = text.begin(); it != text.end(); ++it)	{
+		unsigned char c = *it;
+		width += (c >= 32 && c <= 126 ? characterWidths[c-32] : 556);
+	}
+	// The regular Helvetica is approximately 5 % narrower than the bold one.
+	return (bold ? 1. : 0.95)*width*fontSize/1000.;
+}
+
+string VectorCanvas::escapeText(const string& text, FigureFormat format)	{
+	string escaped;
+	for (string::const_iterator it = text.begin(); it != text.end(); ++it)	{
+		if (format == SVG_FORMAT)	{
+			switch (*it)	{
+				case '&': escaped += "&amp;"; break;
+				case '<': escaped += "&lt;"; break;
+				case '>': escaped += "&gt;"; break;
+				default: escaped += *it;
+			}
+		} else {
+			if (*it == '(' || *it == ')' || *it == '\\')
+				escaped += '\\';
+			escaped += *it;
+		}
+	}
+	return escaped;
+}
+
@@ -0,0 +1,88 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef VECTOR_CANVAS_H
+#define VECTOR_CANVAS_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "BufferedWriter.h"
+#include "DefaultParameters.h"
+
+// The TikZ line widths and the Latex font sizes in points.
+#define THIN_LINE 0.4
+#define THICK_LINE 0.8
+#define NORMAL_FONT 10.0
+#define LARGE_FONT 12.0
+#define VERY_LARGE_FONT 14.4
+#define HUGE_FONT 24.88
+
+struct RGBColor	{
+	double red, green, blue;
+};
+
+// Position of the text relative to the given point, the same meaning as the TikZ node options.
+enum TextPlacement	{
+	TEXT_CENTER = 0, TEXT_LEFT = 1, TEXT_ABOVE = 2, TEXT_BELOW = 3
+};
+
+/*
+ * Single page SVG or PDF figure written without Latex. The coordinates are the TikZ coordinates of the figures,
+ * i.e. centimeters multiplied by the picture scale with the y axis pointing up, the font sizes are in points.
+ * The drawing is streamed to the file and the page size is determined by the bounding box of the drawn primitives.
+ */
+class VectorCanvas {
+	public:
+
+		VectorCanvas(const std::string& file, FigureFormat format, double scale);
+
+		void drawRectangle(double x1, double y1, double x2, double y2, const RGBColor& fill, double lineWidth);
+		void drawLine(double x1, double y1, double x2, double y2, const RGBColor& color, double lineWidth, bool dashed = false, bool arrow = false);
+		// The distance (in points) is added to the separation between the point and the placed text.
+		void drawText(double x, double y, const std::string& text, double fontSize, bool bold, TextPlacement placement = TEXT_CENTER, double distance = 0);
+
+		// It completes the document and closes the file, the write errors are reported by an exception.
+		void close();
+
+		// The xcolor (dvipsnames) color mixed with white, i.e. the equivalent of "color!tint".
+		static RGBColor getColor(const char* name, double tint = 100);
+
+	private:
+
+		VectorCanvas(const VectorCanvas&);
+		VectorCanvas& operator=(const VectorCanvas&);
+
+		void writeCoordinate(double value);
+		void writePoint(double x, double y);
+		void writeColor(const RGBColor& color, bool stroke);
+		void extendBoundingBox(double x, double y);
+
+		static double getTextWidth(const std::string& text, double fontSize, bool bold);
+		static std::string escapeText(const std::string& text, FigureFormat format);
+
+		BufferedWriter output;
+		FigureFormat format;
+		double unit;
+
+		double minX, minY, maxX, maxY;
+		// SVG ~ the reserved view box attributes, PDF ~ the beginning of the content stream.
+		uint64_t reservedPosition;
+		std::vector<uint64_t> objectOffsets;
+};
+
+#endif
+
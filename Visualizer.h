@@ -18,9 +18,9 @@
 #define HLIDAC_PES_VISUALIZER_H
 
 #include <string>
-#include <sstream>
-#include <vector>
 #include <stdint.h>
+#include "BufferedWriter.h"
+#include "ScheduleInstance.h"
 
 #define NUMBER_OF_COLORS 17
 
@@ -28,38 +28,40 @@ class Visualizer {
 
 	public:
 
-		Visualizer(const std::string& fileName);
-		~Visualizer();
+		Visualizer(const ScheduleInstance& instance);
 
 	protected:
 
-		static std::vector<std::string> getLatexTikzHeader();
-		static std::vector<std::string> getTikzStyle();
-		static std::vector<std::string> envelopLatexBody(const std::vector<std::string>& body, double scale);
-		static std::vector<std::string> composeCompleteLatexDocument(const std::vector<std::string>& header,
-				const std::vector<std::string>& style, const std::vector<std::string>& body, double scale);
-
-		static std::string extractLine(std::stringstream& ss);
-		static void writeLinesToFile(const std::string& file, const std::vector<std::string>& doc);
-		
-		std::string freeAllocatedResources(const int32_t& phase = -1);
-
-
-		uint32_t numberOfActivities;
-		uint32_t numberOfResources;
-		uint32_t *activitiesDuration;
-		uint32_t *resourceCapacities;
-		uint32_t **requiredResources;
-		uint32_t *numberOfSuccessors;
-		uint32_t *numberOfPredecessors;
-		uint32_t **successors;
-		uint32_t **predecessors;
-
-		uint32_t projectMakespan;
-		uint32_t *scheduleOrder;
-		uint32_t *startTimesById;
-
-		int32_t ** distanceMatrix;
+		static void writeLatexTikzHeader(BufferedWriter& output);
+		static void writeTikzStyle(BufferedWriter& output);
+		// Header, style and the beginning of the tikzpicture environment, the body is streamed by the caller.
+		static void beginCompleteLatexDocument(BufferedWriter& output, double scale);
+		static void endCompleteLatexDocument(BufferedWriter& output);
+		static std::string toString(uint32_t value);
+
+
+		// Read-only views of the shared instance data, they are owned by ScheduleInstance.
+		// The layout of the arrays is described in ScheduleInstance.h.
+		const uint32_t numberOfActivities;
+		const uint32_t numberOfResources;
+		const uint32_t *activitiesDuration;
+		const uint32_t *resourceCapacities;
+		const uint32_t *requiredResources;
+		const uint32_t *numberOfSuccessors;
+		const uint32_t *numberOfPredecessors;
+		const uint32_t *successorsIndex;
+		const uint32_t *successors;
+		const uint32_t *predecessorsIndex;
+		const uint32_t *predecessors;
+
+		const uint32_t projectMakespan;
+		const uint32_t *scheduleOrder;
+		const uint32_t *startTimesById;
+
+		const uint32_t criticalPathLength;
+		const uint32_t *topologicalOrder;
+		const uint32_t *earliestStartTimes;
+		const uint32_t *latestStartTimes;
 
 		static const char* colors[];
 };
@@ -14,57 +14,105 @@
 	You should have received a copy of the GNU General Public License
 	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
 */
+#include <algorithm>
 #include <string>
-#include <sstream>
 #include <vector>
 #include "DefaultParameters.h"
+#include "TransitiveClosure.h"
 #include "VisualizerGraph.h"
 
 using namespace std;
 
-void VisualizerGraph::writeInstanceGraph(const string& file) const	{
-	vector<string> doc = getGraphAtDotFormat();
-	writeLinesToFile(file, doc);
+void VisualizerGraph::writeInstanceGraph(const string& file, bool reduced) const	{
+	BufferedWriter output(file);
+	writeGraphAtDotFormat(output, reduced);
+	output.close();
 }
 
-vector<string> VisualizerGraph::getGraphAtDotFormat() const	{
-	vector<string> dot;
-	string graphOrientation = ConfigureGraph::graphOrientation;
-	string standardNodeColor = ConfigureGraph::standardNodeColor;
-	string criticalNodeColor = ConfigureGraph::criticalNodeColor;
-	string startNodeColor = ConfigureGraph::startNodeColor, finishNodeColor = ConfigureGraph::finishNodeColor;
-	int32_t criticalPathLength = distanceMatrix[0][numberOfActivities-1];
+void VisualizerGraph::writeGraphAtDotFormat(BufferedWriter& dot, bool reduced) const	{
+	const char* graphOrientation = ConfigureGraph::graphOrientation;
+	const char* standardNodeColor = ConfigureGraph::standardNodeColor;
+	const char* criticalNodeColor = ConfigureGraph::criticalNodeColor;
+	const char* startNodeColor = ConfigureGraph::startNodeColor, *finishNodeColor = ConfigureGraph::finishNodeColor;
 
-	stringstream line(stringstream::in | stringstream::out);
-
-	dot.push_back("digraph G {");
-	line<<"\tgraph[rankdir="<<graphOrientation<<"];"<<endl;
-	dot.push_back(extractLine(line));
-	dot.push_back("\tnode[style=filled, width=\"0.8\", height=\"0.8\", fixedsize=true, margin=\"0,0\"];");
+	dot<<"digraph G {\n";
+	dot<<"\tgraph[rankdir="<<graphOrientation<<"];\n\n";
+	dot<<"\tnode[style=filled, width=\"0.8\", height=\"0.8\", fixedsize=true, margin=\"0,0\"];\n";
 	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
 		if (i == 0)	{
-			line<<"\t"<<i<<" [fillcolor="<<startNodeColor<<", shape=doublecircle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];";
+			dot<<"\t"<<i<<" [fillcolor="<<startNodeColor<<", shape=doublecircle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];\n";
 		} else if (i+1 == numberOfActivities)	{
-			line<<"\t"<<i<<" [fillcolor="<<finishNodeColor<<", shape=doublecircle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];";
+			dot<<"\t"<<i<<" [fillcolor="<<finishNodeColor<<", shape=doublecircle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];\n";
 		} else	{
-			string nodeColor;
-		        if (distanceMatrix[0][i]+distanceMatrix[i][numberOfActivities-1] == criticalPathLength)
+			const char* nodeColor;
+			if (earliestStartTimes[i] == latestStartTimes[i])
 				nodeColor = criticalNodeColor;
 			else
 				nodeColor = standardNodeColor;
-			line<<"\t"<<i<<" [fillcolor="<<nodeColor<<", shape=circle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];";
+			dot<<"\t"<<i<<" [fillcolor="<<nodeColor<<", shape=circle, label=\""<<i<<"\\n"<<activitiesDuration[i]<<"\"];\n";
+		}
+	}
+	dot<<"\n";
+
+	if (reduced)	{
+		// The activities of the same level are not related, i.e. they can be placed at the same rank.
+		vector<uint32_t> activitiesLevel = getActivitiesLevel();
+		uint32_t numberOfLevels = (numberOfActivities > 0 ? *max_element(activitiesLevel.begin(), activitiesLevel.end())+1 : 0);
+		vector<vector<uint32_t> > levels(numberOfLevels);
+		for (uint32_t i = 0; i < numberOfActivities; ++i)
+			levels[activitiesLevel[i]].push_back(i);
+
+		for (vector<vector<uint32_t> >::const_iterator it = levels.begin(); it != levels.end(); ++it)	{
+			if (it->size() > 1)	{
+				dot<<"\t{rank=same;";
+				for (vector<uint32_t>::const_iterator activityIt = it->begin(); activityIt != it->end(); ++activityIt)
+					dot<<" "<<*activityIt<<";";
+				dot<<"}\n";
+			}
 		}
-		dot.push_back(extractLine(line));
+		dot<<"\n";
 	}
-	dot.push_back("");
 
+	vector<bool> writtenArcs = (reduced ? getNonTransitiveArcs() : vector<bool>(successorsIndex[numberOfActivities], true));
 	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		for (uint32_t j = 0; j < numberOfSuccessors[i]; ++j)	{
-			line<<"\t"<<i<<" -> "<<successors[i][j]<<";";
-			dot.push_back(extractLine(line));
+		for (uint32_t j = successorsIndex[i]; j < successorsIndex[i+1]; ++j)	{
+			if (writtenArcs[j])
+				dot<<"\t"<<i<<" -> "<<successors[j]<<";\n";
 		}
 	}
-	dot.push_back("}");
+	dot<<"}\n";
+}
 
-	return dot;
+vector<bool> VisualizerGraph::getNonTransitiveArcs() const	{
+	TransitiveClosure allSuccessors(numberOfActivities, successorsIndex, successors, topologicalOrder, true);
+	uint32_t numberOfWords = allSuccessors.getNumberOfWords();
+	vector<bool> nonTransitiveArcs(successorsIndex[numberOfActivities], true);
+	vector<uint64_t> indirectSuccessors(numberOfWords);
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		// The activities reachable through any direct successor, the arcs leading to them are transitive.
+		fill(indirectSuccessors.begin(), indirectSuccessors.end(), 0);
+		for (uint32_t j = successorsIndex[i]; j < successorsIndex[i+1]; ++j)	{
+			const uint64_t *row = allSuccessors.getRow(successors[j]);
+			for (uint32_t w = 0; w < numberOfWords; ++w)
+				indirectSuccessors[w] |= row[w];
+		}
+
+		for (uint32_t j = successorsIndex[i]; j < successorsIndex[i+1]; ++j)	{
+			uint32_t successorId = successors[j];
+			if ((indirectSuccessors[successorId/64] >> (successorId % 64)) & 1)
+				nonTransitiveArcs[j] = false;
+		}
+	}
+
+	return nonTransitiveArcs;
+}
+
+vector<uint32_t> VisualizerGraph::getActivitiesLevel() const	{
+	vector<uint32_t> activitiesLevel(numberOfActivities, 0);
+	for (uint32_t k = 0; k < numberOfActivities; ++k)	{
+		uint32_t activityId = topologicalOrder[k];
+		for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)
+			activitiesLevel[successors[j]] = max(activitiesLevel[successors[j]], activitiesLevel[activityId]+1);
+	}
+	return activitiesLevel;
 }
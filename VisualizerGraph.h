@@ -24,12 +24,18 @@
 class VisualizerGraph : public Visualizer {
 	public:
 
-		VisualizerGraph(const std::string& file) : Visualizer(file) { };	  
-		void writeInstanceGraph(const std::string& file) const;
+		VisualizerGraph(const ScheduleInstance& instance) : Visualizer(instance) { };	  
+		// The reduced graph omits the transitive arcs and ranks the activities by their levels, i.e. it is laid out much faster.
+		void writeInstanceGraph(const std::string& file, bool reduced = false) const;
 		
 	private:
 	  
-		std::vector<std::string> getGraphAtDotFormat() const;
+		void writeGraphAtDotFormat(BufferedWriter& dot, bool reduced) const;
+
+		// It returns false for the arcs implied by the other arcs, e.g. i -> k if i -> j -> k.
+		std::vector<bool> getNonTransitiveArcs() const;
+		// The level of the activity is the maximal number of the arcs on a path from the start activity.
+		std::vector<uint32_t> getActivitiesLevel() const;
 };
 
 #endif
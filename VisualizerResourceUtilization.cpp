@@ -15,212 +15,649 @@
 	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
 */
 #include <algorithm>
-#include <string>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <sstream>
+#include <string>
 #include <stdexcept>
 #include <vector>
 #include <utility>
 #include <stdint.h>
 #include "BlocksPlacerGLPK.h"
+#include "BlocksPlacerHeuristic.h"
 #include "DefaultParameters.h"
+#include "Profiler.h"
 #include "VisualizerResourceUtilization.h"
+#include "WorkerPool.h"
 
 #ifdef __GNUC__
+#include <cerrno>
 #include <signal.h>
 #include <unistd.h>
-#include <sys/mman.h>
+#include <pthread.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #endif
 
 using namespace std;
 
-void VisualizerResourceUtilization::writeResourceUtilization(const string& file)  const	{
-	vector<string> doc = composeCompleteLatexDocument(getLatexTikzHeader(), getTikzStyle(), getResourceUtilizationLatexBody1(), 0.9);
-	writeLinesToFile(file, doc);
+void VisualizerResourceUtilization::writeResourceUtilization(const string& file, FigureFormat format)  const	{
+	vector<vector<ResourceBlock> > profiles;
+	for (uint32_t r = 0; r < numberOfResources; ++r)
+		profiles.push_back(getResourceProfile(r));
+
+	vector<string> files = getChartFiles(file);
+	for (uint32_t tile = 0; tile < files.size(); ++tile)	{
+		uint32_t startTime, finishTime;
+		getTileSpan(tile, startTime, finishTime);
+		if (format != TIKZ_FORMAT)	{
+			VectorCanvas canvas(files[tile], format, 0.9);
+			drawResourceUtilization1(canvas, profiles, startTime, finishTime);
+			canvas.close();
+		} else {
+			BufferedWriter output(files[tile]);
+			beginCompleteLatexDocument(output, 0.9);
+			writeResourceUtilizationLatexBody1(output, profiles, startTime, finishTime);
+			endCompleteLatexDocument(output);
+			output.close();
+		}
+	}
 }
 
-void VisualizerResourceUtilization::writeResourceUtilizationILP(const string& file)  const	{
-	/* TRY TO GET LATEX SOURCE */
-	vector<string> doc;
-	try {
-		doc = composeCompleteLatexDocument(getLatexTikzHeader(), getTikzStyle(), getResourceUtilizationLatexBody2(), 0.8);
-	} catch (exception& e)	{
-		// Probably ILP isn't able to solve blocks positions.
-		throw runtime_error(e.what());
+uint64_t VisualizerResourceUtilization::writeResourceUtilizationILP(const string& file, WorkerPool& pool, FigureFormat format, BlocksPlacerType placer, const PlacementCache *cache)  const	{
+	// The blocks are placed before the file is created, ILP may fail to solve the blocks positions.
+	ProfiledStage placementStage("block placement");
+	vector<vector<ResourceBlock> > placedBlocks = getPlacedBlocks(pool, placer, cache);
+	placementStage.finish();
+
+	ProfiledStage renderingStage("resource utilization rendering");
+	vector<string> files = getChartFiles(file);
+	for (uint32_t tile = 0; tile < files.size(); ++tile)	{
+		uint32_t startTime, finishTime;
+		getTileSpan(tile, startTime, finishTime);
+		if (format != TIKZ_FORMAT)	{
+			VectorCanvas canvas(files[tile], format, 0.8);
+			drawResourceUtilization2(canvas, placedBlocks, startTime, finishTime);
+			canvas.close();
+		} else {
+			BufferedWriter output(files[tile]);
+			beginCompleteLatexDocument(output, 0.8);
+			writeResourceUtilizationLatexBody2(output, placedBlocks, startTime, finishTime);
+			endCompleteLatexDocument(output);
+			output.close();
+		}
 	}
-	writeLinesToFile(file, doc);
+
+	// The objective of the ILP model, i.e. the sum of r_{i,k}*d_i*y_i over all the resources.
+	uint64_t criterion = 0;
+	for (uint32_t r = 0; r < numberOfResources; ++r)	{
+		for (vector<ResourceBlock>::const_iterator it = placedBlocks[r].begin(); it != placedBlocks[r].end(); ++it)
+			criterion += ((uint64_t) it->y2-it->y1)*(it->x2-it->x1)*it->y1;
+	}
+
+	return criterion;
+}
+
+vector<string> VisualizerResourceUtilization::getChartFiles(const string& file) const	{
+	vector<string> files;
+	uint32_t numberOfTiles = getNumberOfTiles();
+	if (numberOfTiles > 1)	{
+		for (uint32_t tile = 1; tile <= numberOfTiles; ++tile)
+			files.push_back(getTileFile(file, tile));
+	} else {
+		files.push_back(file);
+	}
+	return files;
 }
 
-vector<string> VisualizerResourceUtilization::getResourceUtilizationLatexBody1() const	{
+string VisualizerResourceUtilization::getTileFile(const string& file, uint32_t tile)	{
+	size_t dotPosition = file.find_last_of('.'), slashPosition = file.find_last_of("/\\");
+	if (dotPosition == string::npos || (slashPosition != string::npos && dotPosition < slashPosition))
+		dotPosition = file.size();
+	return file.substr(0, dotPosition)+"_"+toString(tile)+file.substr(dotPosition);
+}
+
+uint32_t VisualizerResourceUtilization::getNumberOfTiles() const	{
+	uint32_t tileWidth = ConfigureResourceUtilization::tileWidth;
+	if (tileWidth == 0 || projectMakespan <= tileWidth)
+		return 1;
+	return (((uint64_t) projectMakespan)+tileWidth-1)/tileWidth;
+}
+
+void VisualizerResourceUtilization::getTileSpan(uint32_t tile, uint32_t& startTime, uint32_t& finishTime) const	{
+	if (getNumberOfTiles() > 1)	{
+		uint32_t tileWidth = ConfigureResourceUtilization::tileWidth;
+		startTime = tile*tileWidth;
+		finishTime = min(startTime+tileWidth, projectMakespan);
+	} else {
+		startTime = 0;
+		finishTime = projectMakespan;
+	}
+}
+
+uint32_t VisualizerResourceUtilization::getTicsSpacing(uint32_t timeSpan)	{
+	// The smallest spacing of the sequence 1, 2, 5, 10, 20, 50, ... which does not exceed the number of tics.
+	// The charts without the tiles keep one tic per time unit.
+	if (ConfigureResourceUtilization::tileWidth == 0)
+		return 1;
+	uint64_t maxNumberOfTics = max(ConfigureResourceUtilization::maxNumberOfTics, (uint32_t) 1);
+	const uint64_t multipliers[] = { 1, 2, 5 };
+	for (uint64_t magnitude = 1; ; magnitude *= 10)	{
+		for (uint32_t m = 0; m < 3; ++m)	{
+			uint64_t spacing = multipliers[m]*magnitude;
+			if (spacing*maxNumberOfTics >= timeSpan)
+				return spacing;
+		}
+	}
+}
+
+bool VisualizerResourceUtilization::clipBlock(const ResourceBlock& block, uint32_t startTime, uint32_t finishTime, ResourceBlock& clippedBlock)	{
+	if (block.x2 <= startTime || block.x1 >= finishTime)
+		return false;
+
+	clippedBlock = block;
+	clippedBlock.x1 = max(block.x1, startTime);
+	clippedBlock.x2 = min(block.x2, finishTime);
+	return true;
+}
+
+void VisualizerResourceUtilization::writeResourceUtilizationLatexBody1(BufferedWriter& latexBody, const vector<vector<ResourceBlock> >& profiles,
+		uint32_t startTime, uint32_t finishTime) const	{
 
-	vector<string> latexBody;
 	vector<uint32_t> axisOrigins = getAxisShiftY();
-	stringstream line(stringstream::in | stringstream::out);
 
 	for (uint32_t r = 0; r < numberOfResources; ++r)	{
 		uint32_t axisOriginY = axisOrigins[r];
 
-		vector<string> axisSource = getResourceAxisLatexSource(r, axisOriginY);
-		latexBody.insert(latexBody.end(), axisSource.begin(), axisSource.end());
+		writeResourceAxisLatexSource(latexBody, r, axisOriginY, startTime, finishTime);
 
-		uint32_t * resourceUtilization = new uint32_t[projectMakespan];
-		fill(resourceUtilization, resourceUtilization+projectMakespan, 0);
-		for (uint32_t t = 0; t < projectMakespan; ++t)	{
-			vector<uint32_t> activeActivities;
-			for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-				if (startTimesById[i] <= t && t < startTimesById[i]+activitiesDuration[i] && requiredResources[i][r] > 0)
-					activeActivities.push_back(i);
-			}
-			
-			if (!activeActivities.empty())	{
-				double x1 = t, x2 = t+1.;
-				double mx = (x2-x1)/2.+t;
-				for (vector<uint32_t>::const_iterator it = activeActivities.begin(); it != activeActivities.end(); ++it)	{
-					uint32_t activityId = *it;
-					uint32_t activityRequirement = requiredResources[activityId][r];
-					double y1 = resourceUtilization[t], y2 = resourceUtilization[t]+activityRequirement;
-					line<<"\t\t\\draw [fill="<<colors[(activityId % (NUMBER_OF_COLORS-2))+2]<<"!30]";
-				        line<<" ("<<x1<<","<<y1+axisOriginY<<") rectangle ("<<x2<<","<<y2+axisOriginY<<");";
-					latexBody.push_back(extractLine(line));
-					double my = (y2-y1)/2.+resourceUtilization[t];
-					line<<"\t\t\\draw ("<<mx<<","<<my+axisOriginY<<") node {\\bf\\large "<<activityId<<"};";
-					latexBody.push_back(extractLine(line));
-
-					resourceUtilization[t] += activityRequirement;
+		ResourceBlock block;
+		for (vector<ResourceBlock>::const_iterator it = profiles[r].begin(); it != profiles[r].end(); ++it)	{
+			if (!clipBlock(*it, startTime, finishTime, block))
+				continue;
+
+			double mx = (block.x1+block.x2)/2., my = (block.y1+block.y2)/2.;
+			latexBody<<"\t\t\\draw [fill="<<colors[(block.activityId % (NUMBER_OF_COLORS-2))+2]<<"!30]";
+			latexBody<<" ("<<block.x1<<","<<block.y1+axisOriginY<<") rectangle ("<<block.x2<<","<<block.y2+axisOriginY<<");\n";
+			latexBody<<"\t\t\\draw ("<<mx<<","<<my+axisOriginY<<") node {\\bf\\large "<<block.activityId<<"};\n";
+		}
+	}
+}
+
+vector<ResourceBlock> VisualizerResourceUtilization::getResourceProfile(const uint32_t& resourceId) const	{
+	/* START AND FINISH EVENTS */
+	vector<pair<uint32_t, uint32_t> > startEvents, finishEvents;
+	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
+		uint32_t finishTime = min(startTimesById[i]+activitiesDuration[i], projectMakespan);
+		if (requiredResources[i*numberOfResources+resourceId] > 0 && startTimesById[i] < finishTime)	{
+			startEvents.push_back(pair<uint32_t, uint32_t>(startTimesById[i], i));
+			finishEvents.push_back(pair<uint32_t, uint32_t>(finishTime, i));
+		}
+	}
+	sort(startEvents.begin(), startEvents.end());
+	sort(finishEvents.begin(), finishEvents.end());
+
+	/* SWEEP THE TIME AXIS */
+	// The active activities are stacked in the order of their identifications. The block of the activity is extended
+	// while the activity keeps its vertical position, i.e. one block is drawn instead of one block per event interval.
+	vector<ResourceBlock> profile;
+	map<uint32_t, ResourceBlock> activeBlocks;
+	uint32_t s = 0, f = 0;
+	while (f < finishEvents.size())	{
+		uint32_t t = finishEvents[f].first;
+		if (s < startEvents.size())
+			t = min(t, startEvents[s].first);
+		for (; f < finishEvents.size() && finishEvents[f].first == t; ++f)	{
+			map<uint32_t, ResourceBlock>::iterator it = activeBlocks.find(finishEvents[f].second);
+			profile.push_back(it->second);
+			activeBlocks.erase(it);
+		}
+		for (; s < startEvents.size() && startEvents[s].first == t; ++s)	{
+			ResourceBlock block;
+			block.activityId = startEvents[s].second;
+			block.x1 = block.x2 = t;
+			block.y1 = block.y2 = 0;
+			activeBlocks[block.activityId] = block;
+		}
+
+		if (!activeBlocks.empty())	{
+			// The active set is constant until the next event.
+			uint32_t nextT = finishEvents[f].first;
+			if (s < startEvents.size())
+				nextT = min(nextT, startEvents[s].first);
+
+			uint32_t y = 0;
+			for (map<uint32_t, ResourceBlock>::iterator it = activeBlocks.begin(); it != activeBlocks.end(); ++it)	{
+				ResourceBlock& block = it->second;
+				if (block.x1 < block.x2 && block.y1 != y)	{
+					// The activity is moved, the block drawn so far is finished.
+					profile.push_back(block);
+					block.x1 = t;
 				}
+				block.x2 = nextT;
+				block.y1 = y; block.y2 = y+requiredResources[(it->first)*numberOfResources+resourceId];
+				y = block.y2;
 			}
 		}
-
-		delete[] resourceUtilization;
 	}
 
-	return latexBody;
+	return profile;
 }
 
+/*
+ * The blocks of one resource which are not separated by an idle time point of the resource. The blocks of different
+ * components never overlap in time, therefore each component is placed independently. The arrays are indexed
+ * by the position of the block in the component, i.e. the component is a standalone single resource problem.
+ */
+struct BlocksPlacementProblem	{
+	uint32_t resourceId;
+	uint32_t resourceCapacity;
+	std::vector<uint32_t> activityIds;
+	std::vector<uint32_t> startTimes;
+	std::vector<uint32_t> durations;
+	std::vector<uint32_t> requirements;
+	BlocksPlacerType placer;
+	const PlacementCache *cache;
+};
+
+/*
+ * Solver processes of one file. If a placement fails, the running solvers of the file are killed.
+ */
+class SolverProcesses	{
+	public:
+		SolverProcesses() : cancelled(false) {
+			#ifdef __GNUC__
+			pthread_mutex_init(&mutex, NULL);
+			#endif
+		}
+
+		~SolverProcesses()	{
+			#ifdef __GNUC__
+			pthread_mutex_destroy(&mutex);
+			#endif
+		}
+
+		#ifdef __GNUC__
+		// It returns false if the placement was already cancelled, the process is killed in that case.
+		bool add(pid_t pid)	{
+			pthread_mutex_lock(&mutex);
+			if (cancelled)
+				kill(pid, SIGKILL);
+			else
+				runningProcesses.push_back(pid);
+			bool added = !cancelled;
+			pthread_mutex_unlock(&mutex);
+			return added;
+		}
+
+		void remove(pid_t pid)	{
+			pthread_mutex_lock(&mutex);
+			vector<pid_t>::iterator it = find(runningProcesses.begin(), runningProcesses.end(), pid);
+			if (it != runningProcesses.end())
+				runningProcesses.erase(it);
+			pthread_mutex_unlock(&mutex);
+		}
+		#endif
+
+		void cancel()	{
+			#ifdef __GNUC__
+			pthread_mutex_lock(&mutex);
+			for (vector<pid_t>::const_iterator it = runningProcesses.begin(); it != runningProcesses.end(); ++it)
+				kill(*it, SIGKILL);
+			runningProcesses.clear();
+			cancelled = true;
+			pthread_mutex_unlock(&mutex);
+			#else
+			cancelled = true;
+			#endif
+		}
+
+		bool isCancelled()	{
+			#ifdef __GNUC__
+			pthread_mutex_lock(&mutex);
+			bool result = cancelled;
+			pthread_mutex_unlock(&mutex);
+			return result;
+			#else
+			return cancelled;
+			#endif
+		}
+
+	private:
+
+		bool cancelled;
+		#ifdef __GNUC__
+		pthread_mutex_t mutex;
+		vector<pid_t> runningProcesses;
+		#endif
+};
+
+/*
+ * The blocks of one component are placed by the ILP solver. GLPK is not thread-safe, hence each solver
+ * runs in its own process and the result is sent back through a pipe. The number of concurrent solvers
+ * is limited by the number of pool threads.
+ */
+class BlocksPlacementJob : public Job	{
+	public:
+		BlocksPlacementJob(const BlocksPlacementProblem& problem, vector<pair<uint32_t, uint32_t> >& blockPositions,
+				WorkerPool& pool, JobGroup& group, SolverProcesses& processes) : problem(problem),
+				blockPositions(blockPositions), pool(pool), group(group), processes(processes), profiledFile(Profiler::getCurrentFile()) { };
+		void run();
+
+	private:
+
+		bool solveHeuristically();
+		void solveILP();
+		// The positions of the solvers are indexed by the position in the component.
+		void storePositions(const vector<pair<uint32_t, uint32_t> >& componentPositions);
+		#ifdef __GNUC__
+		static void writeToPipe(int fd, const char *data, size_t length);
+		static string readFromPipe(int fd);
+		// It is held from the creation of the pipe to the close of its write end in the parent, i.e. the solvers
+		// forked by the other threads do not inherit the write end and the read of the result is not delayed.
+		static pthread_mutex_t forkMutex;
+		#endif
+
+		const BlocksPlacementProblem& problem;
+		vector<pair<uint32_t, uint32_t> >& blockPositions;
+		WorkerPool& pool;
+		JobGroup& group;
+		SolverProcesses& processes;
+		// The stages of the job are assigned to the file which submitted it.
+		int32_t profiledFile;
+};
+
 #ifdef __GNUC__
-volatile bool unableToSolveILP;
-void processError(int signalNumber)	{
-	unableToSolveILP = true;
-}
+pthread_mutex_t BlocksPlacementJob::forkMutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
-vector<string> VisualizerResourceUtilization::getResourceUtilizationLatexBody2() const	{
+void BlocksPlacementJob::run()	{
+	if (processes.isCancelled())
+		return;
 
-	vector<uint32_t> axisOrigins = getAxisShiftY();
-	stringstream line(stringstream::in | stringstream::out);
+	int32_t previousFile = Profiler::getCurrentFile();
+	Profiler::setCurrentFile(profiledFile);
+	try {
+		// The ILP solver is used if the heuristic does not find a feasible placement.
+		if (problem.placer != HEURISTIC_PLACER || !solveHeuristically())
+			solveILP();
+		Profiler::setCurrentFile(previousFile);
+	} catch (exception& e)	{
+		Profiler::setCurrentFile(previousFile);
+		// The other resources of the file are useless without this one.
+		processes.cancel();
+		pool.cancel(group);
+		stringstream message(stringstream::in | stringstream::out);
+		message<<"Resource "<<problem.resourceId<<": "<<e.what();
+		throw runtime_error(message.str());
+	}
+}
+
+bool BlocksPlacementJob::solveHeuristically()	{
+	try {
+		BlocksPlacerHeuristic placer(problem.activityIds.size(), 1, 0, &problem.startTimes[0],
+				&problem.durations[0], &problem.resourceCapacity, &problem.requirements[0]);
+		storePositions(placer.solve());
+		return true;
+	} catch (exception& e)	{
+		return false;
+	}
+}
+
+void BlocksPlacementJob::solveILP()	{
+	stringstream stageName(stringstream::in | stringstream::out);
+	stageName<<"ILP resource "<<problem.resourceId<<" ("<<problem.activityIds.size()<<" blocks)";
+	ProfiledStage stage(stageName.str());
+
+	vector<pair<uint32_t, uint32_t> > componentPositions;
+	if (problem.cache != NULL && problem.cache->load(problem.resourceCapacity, problem.startTimes, problem.durations, problem.requirements, componentPositions))	{
+		storePositions(componentPositions);
+		return;
+	}
 
-	vector<vector<pair<uint32_t, uint32_t> > > blockPositions;
 	#ifdef __GNUC__
-	vector<pid_t> childs;
-	unableToSolveILP = false;
-	pid_t parentPid = getpid();
-	// User handler - receive info about ILP error.
-	signal(SIGUSR1, processError);
-	// Allocate inter-process shared memory.
-	uint32_t *sharedMemory = (uint32_t*) mmap(NULL, (2*numberOfActivities*numberOfResources+numberOfResources)*sizeof(uint32_t),
-			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
-	for (uint32_t r = 0; r < numberOfResources; ++r)	{
-		pid_t pid = fork();
-		if (pid == 0)	{
-			// Child process.
-			try {
-				vector<pair<uint32_t,uint32_t> > yOffsets;
-
-				// Solve ILP problem.
-				BlocksPlacerGLPK solver(numberOfActivities, r, startTimesById, activitiesDuration,
-						resourceCapacities, requiredResources);
-				yOffsets = solver.solve();
-
-				// Write result to inter-process shared memory.
-				uint32_t idx = 2*r*numberOfActivities;
-				for (uint32_t i = 0; i < yOffsets.size(); ++i)	{
-					sharedMemory[idx++] = yOffsets[i].first;
-					sharedMemory[idx++] = yOffsets[i].second;
-				}
-				sharedMemory[2*numberOfActivities*numberOfResources+r] = 2*yOffsets.size();
-
-				_exit(EXIT_SUCCESS);
-			} catch (exception& e)	{
-				// Send error signal to parent.
-				cerr<<"VisualizerResourceUtilization::getResourceUtilizationLatexBody2: "<<e.what()<<endl;
-				kill(parentPid, SIGUSR1);
-				_exit(EXIT_FAILURE);
+	int fd[2];
+	pthread_mutex_lock(&forkMutex);
+	if (pipe(fd) != 0)	{
+		pthread_mutex_unlock(&forkMutex);
+		throw runtime_error("BlocksPlacementJob::solveILP: Cannot create a pipe!");
+	}
+
+	pid_t pid = fork();
+	if (pid == 0)	{
+		// Child process, the result is written as [0, positions] or [1, error message].
+		close(fd[0]);
+		string message(1, '\0');
+		try {
+			BlocksPlacerGLPK solver(problem.activityIds.size(), 1, 0, &problem.startTimes[0],
+					&problem.durations[0], &problem.resourceCapacity, &problem.requirements[0]);
+			vector<pair<uint32_t, uint32_t> > yOffsets = solver.solve();
+			for (vector<pair<uint32_t, uint32_t> >::const_iterator it = yOffsets.begin(); it != yOffsets.end(); ++it)	{
+				uint32_t position[2] = { it->first, it->second };
+				message.append((const char*) position, sizeof(position));
 			}
-		} else if (pid > 0)	{
-			// Parent process.
-			childs.push_back(pid);
-		} else {
-			// New child cannot be created.
-			for (vector<pid_t>::const_iterator it = childs.begin(); it != childs.end(); ++it)
-				kill(*it, SIGKILL);
-			munmap(sharedMemory, (2*numberOfActivities*numberOfResources+numberOfResources)*sizeof(uint32_t));
-			throw runtime_error("VisualizerResourceUtilization::getResourceUtilizationLatexBody2: Cannot create new process!");
+		} catch (exception& e)	{
+			message = string(1, '\1')+e.what();
 		}
+		writeToPipe(fd[1], message.data(), message.size());
+		close(fd[1]);
+		_exit(message[0] == '\0' ? EXIT_SUCCESS : EXIT_FAILURE);
+	} else if (pid < 0)	{
+		close(fd[0]);
+		close(fd[1]);
+		pthread_mutex_unlock(&forkMutex);
+		throw runtime_error("BlocksPlacementJob::solveILP: Cannot create new process!");
 	}
 
-	for (uint32_t i = 0; i < childs.size(); ++i)	{
-		pid_t ret;
-		int childStatus;
-		do {
-			usleep(10000);
-			ret = waitpid(childs[i], &childStatus, WNOHANG);
-		} while (ret <= 0 && !unableToSolveILP);
+	// Parent process, the read is blocked until the solver finishes.
+	close(fd[1]);
+	pthread_mutex_unlock(&forkMutex);
+	processes.add(pid);
+	string message = readFromPipe(fd[0]);
+	close(fd[0]);
+
+	int childStatus = 0;
+	struct rusage childUsage;
+	memset(&childUsage, 0, sizeof(childUsage));
+	while (wait4(pid, &childStatus, 0, &childUsage) < 0 && errno == EINTR)
+		;
+	processes.remove(pid);
+	stage.addChildCpuTime(childUsage.ru_utime.tv_sec+childUsage.ru_utime.tv_usec/1e6+childUsage.ru_stime.tv_sec+childUsage.ru_stime.tv_usec/1e6);
+
+	if (!message.empty() && message[0] == '\1')
+		throw runtime_error(message.substr(1));
+
+	if (message.empty() || (message.size()-1) % (2*sizeof(uint32_t)) != 0 || !WIFEXITED(childStatus) || WEXITSTATUS(childStatus) != EXIT_SUCCESS)	{
+		if (processes.isCancelled())
+			return;
+		throw runtime_error("BlocksPlacementJob::solveILP: The solver process was terminated!");
+	}
 
-		if (unableToSolveILP)	{
-			for (uint32_t k = (ret > 0 ? i+1 : i); k < childs.size(); ++k)
-				kill(childs[k], SIGQUIT);
-			munmap(sharedMemory, (2*numberOfActivities*numberOfResources+numberOfResources)*sizeof(uint32_t));
-			throw runtime_error("VisualizerResourceUtilization::getResourceUtilizationLatexBody2: Invalid to solve ILP problem!");
-		}
+	for (size_t i = 1; i < message.size(); i += 2*sizeof(uint32_t))	{
+		uint32_t position[2];
+		memcpy(position, message.data()+i, sizeof(position));
+		if (position[0] >= problem.activityIds.size())
+			throw runtime_error("BlocksPlacementJob::solveILP: Invalid block index was received!");
+		componentPositions.push_back(pair<uint32_t, uint32_t>(position[0], position[1]));
 	}
+	#else
+	BlocksPlacerGLPK solver(problem.activityIds.size(), 1, 0, &problem.startTimes[0],
+			&problem.durations[0], &problem.resourceCapacity, &problem.requirements[0]);
+	componentPositions = solver.solve();
+	#endif
+
+	if (problem.cache != NULL)
+		problem.cache->save(problem.resourceCapacity, problem.startTimes, problem.durations, problem.requirements, componentPositions);
+	storePositions(componentPositions);
+}
+
+void BlocksPlacementJob::storePositions(const vector<pair<uint32_t, uint32_t> >& componentPositions)	{
+	blockPositions.clear();
+	for (vector<pair<uint32_t, uint32_t> >::const_iterator it = componentPositions.begin(); it != componentPositions.end(); ++it)
+		blockPositions.push_back(pair<uint32_t, uint32_t>(problem.activityIds[it->first], it->second));
+}
+
+#ifdef __GNUC__
+void BlocksPlacementJob::writeToPipe(int fd, const char *data, size_t length)	{
+	while (length > 0)	{
+		ssize_t written = write(fd, data, length);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return;
+		data += written;
+		length -= written;
+	}
+}
+
+string BlocksPlacementJob::readFromPipe(int fd)	{
+	string message;
+	char buffer[4096];
+	while (true)	{
+		ssize_t size = read(fd, buffer, sizeof(buffer));
+		if (size < 0 && errno == EINTR)
+			continue;
+		if (size <= 0)
+			break;
+		message.append(buffer, size);
+	}
+	return message;
+}
+#endif
+
+/*
+ * If the blocks of the component overlap at a common time point, they have to be stacked on top of each other.
+ * The criterion is minimized if the blocks are stacked in the order of non-increasing durations.
+ */
+static bool placeStackedBlocks(const BlocksPlacementProblem& component, vector<pair<uint32_t, uint32_t> >& blockPositions)	{
+	uint32_t latestStart = 0, earliestFinish = numeric_limits<uint32_t>::max();
+	for (uint32_t i = 0; i < component.activityIds.size(); ++i)	{
+		latestStart = max(latestStart, component.startTimes[i]);
+		earliestFinish = min(earliestFinish, component.startTimes[i]+component.durations[i]);
+	}
+
+	if (latestStart >= earliestFinish)
+		return false;
 
+	// ((negated duration, activity id), position in the component)
+	vector<pair<pair<int64_t, uint32_t>, uint32_t> > order;
+	for (uint32_t i = 0; i < component.activityIds.size(); ++i)
+		order.push_back(make_pair(make_pair(-((int64_t) component.durations[i]), component.activityIds[i]), i));
+	sort(order.begin(), order.end());
+
+	uint32_t y = 0;
+	for (vector<pair<pair<int64_t, uint32_t>, uint32_t> >::const_iterator it = order.begin(); it != order.end(); ++it)	{
+		blockPositions.push_back(pair<uint32_t, uint32_t>(it->first.second, y));
+		y += component.requirements[it->second];
+	}
+
+	return true;
+}
+
+vector<vector<ResourceBlock> > VisualizerResourceUtilization::getPlacedBlocks(WorkerPool& pool, BlocksPlacerType placer, const PlacementCache *cache) const	{
+
+	/* SPLIT THE RESOURCES AT THE IDLE TIME POINTS */
+	vector<BlocksPlacementProblem> components;
 	for (uint32_t r = 0; r < numberOfResources; ++r)	{
-		vector<pair<uint32_t,uint32_t> > yOffsets;
-		uint32_t offset = 2*r*numberOfActivities;
-		uint32_t numberOfElements = sharedMemory[2*numberOfActivities*numberOfResources+r];
-		for (uint32_t i = offset; i < offset+numberOfElements; i += 2)
-			yOffsets.push_back(pair<uint32_t, uint32_t>(sharedMemory[i], sharedMemory[i+1]));
-		blockPositions.push_back(yOffsets);
+		vector<pair<uint32_t, uint32_t> > blocks;
+		for (uint32_t id = 0; id < numberOfActivities; ++id)	{
+			if (activitiesDuration[id] > 0 && requiredResources[id*numberOfResources+r] > 0)
+				blocks.push_back(pair<uint32_t, uint32_t>(startTimesById[id], id));
+		}
+		sort(blocks.begin(), blocks.end());
+
+		uint32_t componentFinish = 0;
+		for (vector<pair<uint32_t, uint32_t> >::const_iterator it = blocks.begin(); it != blocks.end(); ++it)	{
+			uint32_t id = it->second;
+			if (it == blocks.begin() || it->first >= componentFinish)	{
+				components.push_back(BlocksPlacementProblem());
+				components.back().resourceId = r;
+				components.back().resourceCapacity = resourceCapacities[r];
+				components.back().placer = placer;
+				components.back().cache = cache;
+				componentFinish = 0;
+			}
+
+			BlocksPlacementProblem& component = components.back();
+			component.activityIds.push_back(id);
+			component.startTimes.push_back(startTimesById[id]);
+			component.durations.push_back(activitiesDuration[id]);
+			component.requirements.push_back(requiredResources[id*numberOfResources+r]);
+			componentFinish = max(componentFinish, startTimesById[id]+activitiesDuration[id]);
+		}
 	}
 
-	// Free allocated shared memory.
-	munmap(sharedMemory, (2*numberOfActivities*numberOfResources+numberOfResources)*sizeof(uint32_t));
-	#else
+	/* PLACE THE COMPONENTS */
+	SolverProcesses processes;
+	JobGroup placementJobs;
+	vector<vector<pair<uint32_t, uint32_t> > > blockPositions(components.size());
+	for (uint32_t c = 0; c < components.size(); ++c)	{
+		// The small components are solved directly, the others by the solvers in parallel.
+		if (!placeStackedBlocks(components[c], blockPositions[c]))
+			pool.submit(new BlocksPlacementJob(components[c], blockPositions[c], pool, placementJobs, processes), placementJobs);
+	}
+	pool.wait(placementJobs);
+
+	if (!placementJobs.getErrors().empty())	{
+		string errorMessage = "VisualizerResourceUtilization::getPlacedBlocks: Invalid to solve ILP problem!";
+		const vector<string>& errors = placementJobs.getErrors();
+		for (vector<string>::const_iterator it = errors.begin(); it != errors.end(); ++it)
+			errorMessage += "\n\t"+*it;
+		throw runtime_error(errorMessage);
+	}
+
+	/* STITCH THE COMPONENTS TOGETHER */
+	vector<vector<pair<uint32_t, uint32_t> > > resourcePositions(numberOfResources);
+	for (uint32_t c = 0; c < components.size(); ++c)	{
+		vector<pair<uint32_t, uint32_t> >& positions = resourcePositions[components[c].resourceId];
+		positions.insert(positions.end(), blockPositions[c].begin(), blockPositions[c].end());
+	}
+
+	vector<vector<ResourceBlock> > placedBlocks(numberOfResources);
 	for (uint32_t r = 0; r < numberOfResources; ++r)	{
-		BlocksPlacerGLPK solver(numberOfActivities, r, startTimesById, activitiesDuration,
-			       	resourceCapacities, requiredResources);
-		blockPositions.push_back(solver.solve());
+		sort(resourcePositions[r].begin(), resourcePositions[r].end());
+		for (uint32_t i = 0; i < resourcePositions[r].size(); ++i)	{
+			ResourceBlock block;
+			block.activityId = resourcePositions[r][i].first;
+			block.x1 = startTimesById[block.activityId];
+			block.x2 = block.x1+activitiesDuration[block.activityId];
+			block.y1 = resourcePositions[r][i].second;
+			block.y2 = block.y1+requiredResources[block.activityId*numberOfResources+r];
+			placedBlocks[r].push_back(block);
+		}
 	}
-	#endif
 
-	vector<string> latexBody;
+	return placedBlocks;
+}
+
+void VisualizerResourceUtilization::writeResourceUtilizationLatexBody2(BufferedWriter& latexBody, const vector<vector<ResourceBlock> >& placedBlocks,
+		uint32_t startTime, uint32_t finishTime) const	{
+
+	vector<uint32_t> axisOrigins = getAxisShiftY();
+
 	for (uint32_t r = 0; r < numberOfResources; ++r)	{
 		uint32_t axisOriginY = axisOrigins[r];
-		vector<string> axisSource = getResourceAxisLatexSource(r, axisOriginY);
-		latexBody.insert(latexBody.end(), axisSource.begin(), axisSource.end());
+		writeResourceAxisLatexSource(latexBody, r, axisOriginY, startTime, finishTime);
 
 		/* PLACE ACTIVITIES TO SCHEDULE */
-		latexBody.push_back("\t\t%% Draw activities blocks.");
-		for (uint32_t i = 0; i < blockPositions[r].size(); ++i)	{
-			uint32_t id = blockPositions[r][i].first;
-			uint32_t x1 = startTimesById[id];
-			uint32_t y1 = blockPositions[r][i].second+axisOriginY;
-			uint32_t x2 = x1+activitiesDuration[id];
-			uint32_t y2 = y1+requiredResources[id][r];
-			double mx = ((double) x1+x2)/2.;
+		latexBody<<"\t\t%% Draw activities blocks.\n";
+		ResourceBlock block;
+		for (vector<ResourceBlock>::const_iterator it = placedBlocks[r].begin(); it != placedBlocks[r].end(); ++it)	{
+			if (!clipBlock(*it, startTime, finishTime, block))
+				continue;
+
+			uint32_t y1 = block.y1+axisOriginY, y2 = block.y2+axisOriginY;
+			double mx = ((double) block.x1+block.x2)/2.;
 			double my = ((double) y1+y2)/2.;
 
-			line<<"\t\t\\draw[blockstyle] ("<<x1<<","<<y1<<") rectangle ("<<x2<<","<<y2<<");";
-			latexBody.push_back(extractLine(line));
-			line<<"\t\t\\draw ("<<mx<<","<<my<<") node {\\bf\\large "<<id<<"};";
-			latexBody.push_back(extractLine(line));
+			latexBody<<"\t\t\\draw[blockstyle] ("<<block.x1<<","<<y1<<") rectangle ("<<block.x2<<","<<y2<<");\n";
+			latexBody<<"\t\t\\draw ("<<mx<<","<<my<<") node {\\bf\\large "<<block.activityId<<"};\n";
 		}
 
-		latexBody.push_back("");
+		latexBody<<"\n";
 	}
-
-	return latexBody;
 }
 
 vector<uint32_t> VisualizerResourceUtilization::getAxisShiftY() const	{
@@ -235,55 +672,121 @@ vector<uint32_t> VisualizerResourceUtilization::getAxisShiftY() const	{
 	return axisOrigins;
 }
 
-vector<string> VisualizerResourceUtilization::getResourceAxisLatexSource(const uint32_t& resourceId, const uint32_t& axisOriginY)	const	{
+void VisualizerResourceUtilization::writeResourceAxisLatexSource(BufferedWriter& axisLatexSource, const uint32_t& resourceId, const uint32_t& axisOriginY,
+		uint32_t startTime, uint32_t finishTime) const	{
 	double axisElongationX = ConfigureResourceUtilization::axisElongationX;
 	double axisElongationY = ConfigureResourceUtilization::axisElongationY;
 	double textDist = ConfigureResourceUtilization::textDist;
 	double ticsLength = ConfigureResourceUtilization::ticsLength;
 
-	vector<string> axisLatexSource;
-	stringstream line(stringstream::in | stringstream::out);
 	uint32_t resourceCapacity = resourceCapacities[resourceId];
 
 	/* LATEX SOURCE - START INFO */
-	line<<"\t\t%% RESOURCE "<<resourceId<<" LATEX CODE."<<endl;
-	axisLatexSource.push_back(extractLine(line));
+	axisLatexSource<<"\t\t%% RESOURCE "<<resourceId<<" LATEX CODE.\n\n";
 
 	/* AXIS X */
-	axisLatexSource.push_back("\t\t%% Draw X axis.");
-	line<<"\t\t\\draw[axisline] (0,"<<axisOriginY<<") -- ";
-	line<<"("<<projectMakespan+axisElongationX<<","<<axisOriginY<<")";
-	line<<" node [below="<<textDist<<"] {$t\\,[s]$};"<<endl;
-	axisLatexSource.push_back(extractLine(line));
-
-	line<<"\t\t\\foreach \\x in {0,...,"<<projectMakespan<<"}";
-	axisLatexSource.push_back(extractLine(line));
-	line<<"\t\t\t\\draw (\\x,"<<axisOriginY+ticsLength<<") -- ";
-	line<<"(\\x,"<<axisOriginY-ticsLength<<") node [below] {\\x};"<<endl;
-	axisLatexSource.push_back(extractLine(line));
+	axisLatexSource<<"\t\t%% Draw X axis.\n";
+	axisLatexSource<<"\t\t\\draw[axisline] ("<<startTime<<","<<axisOriginY<<") -- ";
+	axisLatexSource<<"("<<finishTime+axisElongationX<<","<<axisOriginY<<")";
+	axisLatexSource<<" node [below="<<textDist<<"] {$t\\,[s]$};\n\n";
+
+	uint32_t ticsSpacing = getTicsSpacing(finishTime-startTime);
+	uint32_t firstTic = ((startTime+ticsSpacing-1)/ticsSpacing)*ticsSpacing;
+	// TikZ continues "{a,...,b}" by the step 1 (or down if a > b), hence the ellipsis is written only for the complete sequences.
+	if (firstTic <= finishTime)	{
+		axisLatexSource<<"\t\t\\foreach \\x in {"<<firstTic;
+		if (ticsSpacing == 1)
+			axisLatexSource<<",...,"<<finishTime;
+		else if (firstTic+ticsSpacing <= finishTime)
+			axisLatexSource<<","<<firstTic+ticsSpacing<<",...,"<<finishTime;
+		axisLatexSource<<"}\n";
+		axisLatexSource<<"\t\t\t\\draw (\\x,"<<axisOriginY+ticsLength<<") -- ";
+		axisLatexSource<<"(\\x,"<<axisOriginY-ticsLength<<") node [below] {\\x};\n\n";
+	}
 
 	/* AXIS Y */
-	axisLatexSource.push_back("\t\t%% Draw Y axis.");
-	line<<"\t\t\\draw[axisline] (0,"<<axisOriginY<<") -- ";
-	line<<"(0,"<<axisOriginY+axisElongationY+resourceCapacity<<") ";
-	line<<"node [left="<<textDist<<"] {$R_"<<resourceId<<"$};"<<endl;
-	axisLatexSource.push_back(extractLine(line));
-
-	line<<"\t\t\\foreach \\y in {0,...,"<<resourceCapacity<<"}";
-	axisLatexSource.push_back(extractLine(line));
-	line<<"\t\t\t\\draw ("<<ticsLength<<",\\y+"<<axisOriginY<<") -- ("<<-ticsLength<<",\\y+"<<axisOriginY<<") ";
-	line<<"node [left] {\\y};"<<endl;
-	axisLatexSource.push_back(extractLine(line));
+	axisLatexSource<<"\t\t%% Draw Y axis.\n";
+	axisLatexSource<<"\t\t\\draw[axisline] ("<<startTime<<","<<axisOriginY<<") -- ";
+	axisLatexSource<<"("<<startTime<<","<<axisOriginY+axisElongationY+resourceCapacity<<") ";
+	axisLatexSource<<"node [left="<<textDist<<"] {$R_"<<resourceId<<"$};\n\n";
+
+	axisLatexSource<<"\t\t\\foreach \\y in {0,...,"<<resourceCapacity<<"}\n";
+	axisLatexSource<<"\t\t\t\\draw ("<<startTime+ticsLength<<",\\y+"<<axisOriginY<<") -- ("<<startTime-ticsLength<<",\\y+"<<axisOriginY<<") ";
+	axisLatexSource<<"node [left] {\\y};\n\n";
 
 	/* MAX CAPACITY LINE */
-	axisLatexSource.push_back("\t\t%% Draw max capacity label.");
-	line<<"\t\t\\draw[dashed,color=red] (0,"<<axisOriginY+resourceCapacity<<") -- ";
-	line<<"("<<projectMakespan<<","<<axisOriginY+resourceCapacity<<");";
-	axisLatexSource.push_back(extractLine(line));
-	line<<"\t\t\\draw ("<<projectMakespan<<","<<axisOriginY+resourceCapacity<<") ";
-	line<<"node [above] {$\\textrm{Maximal capacity}$};"<<endl;
-	axisLatexSource.push_back(extractLine(line));
+	axisLatexSource<<"\t\t%% Draw max capacity label.\n";
+	axisLatexSource<<"\t\t\\draw[dashed,color=red] ("<<startTime<<","<<axisOriginY+resourceCapacity<<") -- ";
+	axisLatexSource<<"("<<finishTime<<","<<axisOriginY+resourceCapacity<<");\n";
+	axisLatexSource<<"\t\t\\draw ("<<finishTime<<","<<axisOriginY+resourceCapacity<<") ";
+	axisLatexSource<<"node [above] {$\\textrm{Maximal capacity}$};\n\n";
+}
+
+void VisualizerResourceUtilization::drawResourceUtilization1(VectorCanvas& canvas, const vector<vector<ResourceBlock> >& profiles, uint32_t startTime, uint32_t finishTime) const	{
+	vector<uint32_t> axisOrigins = getAxisShiftY();
+	for (uint32_t r = 0; r < numberOfResources; ++r)	{
+		uint32_t axisOriginY = axisOrigins[r];
+		drawResourceAxis(canvas, r, axisOriginY, startTime, finishTime);
+
+		ResourceBlock block;
+		for (vector<ResourceBlock>::const_iterator it = profiles[r].begin(); it != profiles[r].end(); ++it)	{
+			if (!clipBlock(*it, startTime, finishTime, block))
+				continue;
+
+			double mx = (block.x1+block.x2)/2., my = (block.y1+block.y2)/2.;
+			RGBColor fill = VectorCanvas::getColor(colors[(block.activityId % (NUMBER_OF_COLORS-2))+2], 30);
+			canvas.drawRectangle(block.x1, block.y1+axisOriginY, block.x2, block.y2+axisOriginY, fill, THIN_LINE);
+			canvas.drawText(mx, my+axisOriginY, toString(block.activityId), LARGE_FONT, true);
+		}
+	}
+}
+
+void VisualizerResourceUtilization::drawResourceUtilization2(VectorCanvas& canvas, const vector<vector<ResourceBlock> >& placedBlocks, uint32_t startTime, uint32_t finishTime) const	{
+	RGBColor fill = VectorCanvas::getColor(ConfigureResourceUtilization::blockColor, 20);
+	vector<uint32_t> axisOrigins = getAxisShiftY();
+	for (uint32_t r = 0; r < numberOfResources; ++r)	{
+		uint32_t axisOriginY = axisOrigins[r];
+		drawResourceAxis(canvas, r, axisOriginY, startTime, finishTime);
+
+		ResourceBlock block;
+		for (vector<ResourceBlock>::const_iterator it = placedBlocks[r].begin(); it != placedBlocks[r].end(); ++it)	{
+			if (!clipBlock(*it, startTime, finishTime, block))
+				continue;
+
+			uint32_t y1 = block.y1+axisOriginY, y2 = block.y2+axisOriginY;
+			canvas.drawRectangle(block.x1, y1, block.x2, y2, fill, THICK_LINE);
+			canvas.drawText(((double) block.x1+block.x2)/2., ((double) y1+y2)/2., toString(block.activityId), LARGE_FONT, true);
+		}
+	}
+}
+
+void VisualizerResourceUtilization::drawResourceAxis(VectorCanvas& canvas, const uint32_t& resourceId, const uint32_t& axisOriginY, uint32_t startTime, uint32_t finishTime) const	{
+	double axisElongationX = ConfigureResourceUtilization::axisElongationX;
+	double axisElongationY = ConfigureResourceUtilization::axisElongationY;
+	double textDist = ConfigureResourceUtilization::textDist;
+	double ticsLength = ConfigureResourceUtilization::ticsLength;
+
+	uint32_t resourceCapacity = resourceCapacities[resourceId];
+	RGBColor black = VectorCanvas::getColor("black"), red = VectorCanvas::getColor("red");
+
+	/* AXIS X */
+	canvas.drawLine(startTime, axisOriginY, finishTime+axisElongationX, axisOriginY, black, THICK_LINE, false, true);
+	canvas.drawText(finishTime+axisElongationX, axisOriginY, "t [s]", NORMAL_FONT, false, TEXT_BELOW, textDist);
+	uint32_t ticsSpacing = getTicsSpacing(finishTime-startTime);
+	for (uint64_t x = ((startTime+ticsSpacing-1)/ticsSpacing)*ticsSpacing; x <= finishTime; x += ticsSpacing)	{
+		canvas.drawLine(x, axisOriginY+ticsLength, x, axisOriginY-ticsLength, black, THIN_LINE);
+		canvas.drawText(x, axisOriginY-ticsLength, toString((uint32_t) x), NORMAL_FONT, false, TEXT_BELOW);
+	}
 
-	return axisLatexSource;
-} 
+	/* AXIS Y */
+	canvas.drawLine(startTime, axisOriginY, startTime, axisOriginY+axisElongationY+resourceCapacity, black, THICK_LINE, false, true);
+	canvas.drawText(startTime, axisOriginY+axisElongationY+resourceCapacity, "R"+toString(resourceId), NORMAL_FONT, false, TEXT_LEFT, textDist);
+	for (uint32_t y = 0; y <= resourceCapacity; ++y)	{
+		canvas.drawLine(startTime+ticsLength, y+axisOriginY, startTime-ticsLength, y+axisOriginY, black, THIN_LINE);
+		canvas.drawText(startTime-ticsLength, y+axisOriginY, toString(y), NORMAL_FONT, false, TEXT_LEFT);
+	}
 
+	/* MAX CAPACITY LINE */
+	canvas.drawLine(startTime, axisOriginY+resourceCapacity, finishTime, axisOriginY+resourceCapacity, red, THIN_LINE, true);
+	canvas.drawText(finishTime, axisOriginY+resourceCapacity, "Maximal capacity", NORMAL_FONT, false, TEXT_ABOVE);
+}
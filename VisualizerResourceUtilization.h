@@ -20,22 +20,61 @@
 #include <string>
 #include <vector>
 #include <stdint.h>
+#include "DefaultParameters.h"
+#include "PlacementCache.h"
+#include "VectorCanvas.h"
 #include "Visualizer.h"
+#include "WorkerPool.h"
+
+/*
+ * Rectangle of an activity in the resource utilization chart, the y coordinates are relative to the resource axis.
+ */
+struct ResourceBlock	{
+	uint32_t activityId;
+	uint32_t x1, x2;
+	uint32_t y1, y2;
+};
 
 class VisualizerResourceUtilization : public Visualizer {
 	public:
 	  
-		VisualizerResourceUtilization(const std::string& file) : Visualizer(file) { };
-		void writeResourceUtilization(const std::string& file)	const;
-		void writeResourceUtilizationILP(const std::string& file)	const;
+		VisualizerResourceUtilization(const ScheduleInstance& instance) : Visualizer(instance) { };
+		void writeResourceUtilization(const std::string& file, FigureFormat format = TIKZ_FORMAT)	const;
+		// The blocks of the resources are placed concurrently by the jobs of the pool, the criterion of the placement is returned.
+		// The ILP placements are looked up in the cache (if any) before the solver is started.
+		uint64_t writeResourceUtilizationILP(const std::string& file, WorkerPool& pool, FigureFormat format = TIKZ_FORMAT,
+				BlocksPlacerType placer = ILP_PLACER, const PlacementCache *cache = NULL)	const;
+
+		// The long schedules are split into the tiles of the time axis, each tile is an independent document.
+		// It returns the files the chart is written to, i.e. either the given file or its tiles.
+		std::vector<std::string> getChartFiles(const std::string& file) const;
+		// The file of the k-th tile (from 1), e.g. "x_RU.tex" -> "x_RU_1.tex".
+		static std::string getTileFile(const std::string& file, uint32_t tile);
 		
 	private:
 
-		std::vector<std::string> getResourceUtilizationLatexBody1() const;
-		std::vector<std::string> getResourceUtilizationLatexBody2() const;
+		void writeResourceUtilizationLatexBody1(BufferedWriter& latexBody, const std::vector<std::vector<ResourceBlock> >& profiles,
+				uint32_t startTime, uint32_t finishTime) const;
+		std::vector<std::vector<ResourceBlock> > getPlacedBlocks(WorkerPool& pool, BlocksPlacerType placer, const PlacementCache *cache) const;
+		void writeResourceUtilizationLatexBody2(BufferedWriter& latexBody, const std::vector<std::vector<ResourceBlock> >& placedBlocks,
+				uint32_t startTime, uint32_t finishTime) const;
 		
+		std::vector<ResourceBlock> getResourceProfile(const uint32_t& resourceId) const;
 		std::vector<uint32_t> getAxisShiftY() const;
-		std::vector<std::string> getResourceAxisLatexSource(const uint32_t& resourceId, const uint32_t& axisOriginY)  const;
+		void writeResourceAxisLatexSource(BufferedWriter& axisLatexSource, const uint32_t& resourceId, const uint32_t& axisOriginY,
+				uint32_t startTime, uint32_t finishTime) const;
+
+		// The same figures drawn directly to SVG or PDF.
+		void drawResourceUtilization1(VectorCanvas& canvas, const std::vector<std::vector<ResourceBlock> >& profiles, uint32_t startTime, uint32_t finishTime) const;
+		void drawResourceUtilization2(VectorCanvas& canvas, const std::vector<std::vector<ResourceBlock> >& placedBlocks, uint32_t startTime, uint32_t finishTime) const;
+		void drawResourceAxis(VectorCanvas& canvas, const uint32_t& resourceId, const uint32_t& axisOriginY, uint32_t startTime, uint32_t finishTime) const;
+
+		// The time span [startTime, finishTime] of the tile (from 0).
+		uint32_t getNumberOfTiles() const;
+		void getTileSpan(uint32_t tile, uint32_t& startTime, uint32_t& finishTime) const;
+		static uint32_t getTicsSpacing(uint32_t timeSpan);
+		// The part of the block inside the time span, false if the block is outside.
+		static bool clipBlock(const ResourceBlock& block, uint32_t startTime, uint32_t finishTime, ResourceBlock& clippedBlock);
 };
 
 #endif
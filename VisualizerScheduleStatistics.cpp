@@ -16,334 +16,319 @@
 */
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <map>
+#include <limits>
 #include <numeric>
-#include <iomanip>
 #include <stdexcept>
 #include <string>
-#include <sstream>
 #include <vector>
+#include "AnalysisDataFile.h"
 #include "DefaultParameters.h"
+#include "GroupStatistics.h"
+#include "Profiler.h"
 #include "VisualizerScheduleStatistics.h"
 
 using namespace std;
 
-void VisualizerScheduleStatistics::writeScheduleStatistics(const string& file)   {
-	vector<string> doc = composeCompleteLatexDocument(getLatexTikzHeader(), getTikzStyle(), getScheduleAnalysisLatexBody(file), 0.6);
-	writeLinesToFile(file, doc);
+VisualizerScheduleStatistics::VisualizerScheduleStatistics(const ScheduleInstance& instance) : Visualizer(instance),
+	allSuccessors(numberOfActivities, successorsIndex, successors, topologicalOrder, true),
+	allPredecessors(numberOfActivities, predecessorsIndex, predecessors, topologicalOrder, false)	{
 }
 
-void VisualizerScheduleStatistics::writeGroupStatistics(const string& file, const vector<InstanceResults>& results)	{
+void VisualizerScheduleStatistics::writeScheduleStatistics(const string& file, FigureFormat format)   {
+	AnalysisFigure figure = getScheduleAnalysisFigure(file);
+	if (format != TIKZ_FORMAT)	{
+		VectorCanvas canvas(file, format, 0.6);
+		drawAnalysisFigure(canvas, figure, VERY_LARGE_FONT);
+		canvas.close();
+		return;
+	}
+
+	BufferedWriter output(file);
+	beginCompleteLatexDocument(output, 0.6);
+	writeScheduleAnalysisLatexBody(output, figure);
+	endCompleteLatexDocument(output);
+	output.close();
+}
+
+void VisualizerScheduleStatistics::writeAnalysisData(const string& file)	{
+	if (parameterTable.activitiesFreedom.size() != numberOfActivities)
+		parameterTable = getParameterTable();
+	AnalysisDataFile::write(file, parameterTable);
+}
+
+void VisualizerScheduleStatistics::writeGroupStatistics(const string& file, const GroupStatistics& statistics, FigureFormat format)	{
 	string title = file;
 	replace(title.begin(), title.end(), '_', '-');
 
-	vector<string> doc;
-	vector<string> body = getGroupAnalysisLatexBody(title, results);
-	doc = composeCompleteLatexDocument(getLatexTikzHeader(), getTikzStyle(), body, 0.8);
-	writeLinesToFile(file, doc);
-}
+	AnalysisFigure figure = getGroupAnalysisFigure(title, statistics);
+	if (format != TIKZ_FORMAT)	{
+		VectorCanvas canvas(file, format, 0.8);
+		drawAnalysisFigure(canvas, figure, HUGE_FONT);
+		canvas.close();
+		return;
+	}
 
-vector<string> VisualizerScheduleStatistics::getScheduleAnalysisLatexBody(string instanceTitle) {
-	vector<string> latexBody;
+	BufferedWriter output(file);
+	beginCompleteLatexDocument(output, 0.8);
+	writeGroupAnalysisLatexBody(output, figure);
+	endCompleteLatexDocument(output);
+	output.close();
+}
 
+AnalysisFigure VisualizerScheduleStatistics::getScheduleAnalysisFigure(string instanceTitle) {
+	AnalysisFigure figure;
 	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
 	int32_t yShift = NUMBER_OF_PARAMETERS*boxSize; 
-	int32_t pictureWidth = numberOfActivities*boxSize;
+	int32_t pictureWidth = getNumberOfDrawnColumns(numberOfActivities)*boxSize;
 
-	stringstream line(stringstream::in | stringstream::out);
 	replace(instanceTitle.begin(), instanceTitle.end(), '_', '-');
-	line<<"\t\t\\draw ("<<pictureWidth/2.<<","<<yShift<<") node[above] {\\bf\\Large Visualized parameters - "<<instanceTitle<<"};";
-	latexBody.push_back(extractLine(line));
+	figure.title = "Visualized parameters - "+instanceTitle;
+	figure.titleX = pictureWidth/2.;
+	figure.titleY = yShift;
+
+	ProfiledStage tableStage("statistics table");
+	parameterTable = getParameterTable();
+	tableStage.finish();
+
+	// The values of all the statistics are computed together by the table, the rows are normalized and binned separately.
+	ProfiledStage rowsStage("statistics rows");
 	for (uint32_t p = 0; p < NUMBER_OF_PARAMETERS; ++p)	{
+		ProfiledStage rowStage(Profiler::isEnabled() ? "statistics row - "+getParameterDescription((Parameter) p) : "");
 		yShift -= boxSize;
-		vector<string> partOfBody = getScheduleAnalysisLatexBodyPart((Parameter) p, yShift);
-		latexBody.insert(latexBody.end(), partOfBody.begin(), partOfBody.end());
-		latexBody.push_back("");
+		figure.rows.push_back(getScheduleAnalysisRow(parameterTable, (Parameter) p, yShift));
 	}
 	savedAnalysis.numberOfColumns = numberOfActivities;
-	
-	return latexBody;
-}
 
-vector<string> VisualizerScheduleStatistics::getScheduleAnalysisLatexBodyPart(const Parameter& parameter, uint32_t yShift) {
+	return figure;
+}
 
-	vector<string> partOfBody;
-	string parameterDescription;
-	ParameterResult parameterResults;
+void VisualizerScheduleStatistics::writeScheduleAnalysisLatexBody(BufferedWriter& latexBody, const AnalysisFigure& figure) {
 	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
-	stringstream line(stringstream::in | stringstream::out);
+	latexBody<<"\t\t\\draw ("<<figure.titleX<<","<<figure.titleY<<") node[above] {\\bf\\Large "<<figure.title<<"};\n";
+	for (vector<AnalysisRow>::const_iterator it = figure.rows.begin(); it != figure.rows.end(); ++it)	{
+		latexBody<<"\t\t\\draw (0,"<<boxSize/2.+it->yShift<<") node[left] {\\bf "<<it->label<<"};\n";
+		writeAnalysisRowLatexSource(latexBody, *it);
+		latexBody<<"\n";
+	}
+}
 
+string VisualizerScheduleStatistics::getParameterDescription(Parameter parameter)	{
 	switch (parameter)	{
 		case ACTIVITY_ID:
-			{
-				vector<uint32_t> vectorActivitiesId(scheduleOrder, scheduleOrder+numberOfActivities);
-				partOfBody = getScheduleAnalysisLatexBodyElement(vectorActivitiesId, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterDescription = "Order of activities";
-			}
-			break;
+			return "Order of activities";
 		case ACTIVITY_START_TIME:
-			{
-				vector<uint32_t> vectorStartTimeById(startTimesById, startTimesById+numberOfActivities);
-				vectorStartTimeById = getValuesInOrder(vectorStartTimeById, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(vectorStartTimeById, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterDescription = "Activities start time";
-			}
-			break;
+			return "Activities start time";
 		case ACTIVITY_DURATION:
-			{
-				vector<uint32_t> vectorActivitiesDuration(activitiesDuration, activitiesDuration+numberOfActivities);
-				vectorActivitiesDuration = getValuesInOrder(vectorActivitiesDuration, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(vectorActivitiesDuration, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(vectorActivitiesDuration);
-				parameterDescription = "Activities duration";
-			}
-			break;
+			return "Activities duration";
 		case NUMBER_OF_DIRECT_SUCCESSORS:
-			{
-				vector<uint32_t> vectorNumberOfSuccessors(numberOfSuccessors, numberOfSuccessors+numberOfActivities);
-				vectorNumberOfSuccessors = getValuesInOrder(vectorNumberOfSuccessors, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(vectorNumberOfSuccessors, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(vectorNumberOfSuccessors);
-				parameterDescription = "Number of direct successors";
-			}
-			break;
+			return "Number of direct successors";
 		case NUMBER_OF_DIRECT_PREDECESSORS:
-			{
-				vector<uint32_t> vectorNumberOfPredecessors(numberOfPredecessors, numberOfPredecessors+numberOfActivities);
-				vectorNumberOfPredecessors = getValuesInOrder(vectorNumberOfPredecessors, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(vectorNumberOfPredecessors, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(vectorNumberOfPredecessors);
-				parameterDescription = "Number of direct predecessors";
-			}
-			break;
+			return "Number of direct predecessors";
 		case NUMBER_OF_ALL_SUCCESSORS:
-			{
-				vector<uint32_t> allSuccessors = getNumberOfAllSuccessors();
-				allSuccessors = getValuesInOrder(allSuccessors, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(allSuccessors, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(allSuccessors);
-				parameterDescription = "Number of successors";
-			}
-			break;
+			return "Number of successors";
 		case NUMBER_OF_ALL_PREDECESSORS:
-			{
-				vector<uint32_t> allPredecessors = getNumberOfAllPredecessors();
-				allPredecessors = getValuesInOrder(allPredecessors, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(allPredecessors, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(allPredecessors);
-				parameterDescription = "Number of predecessors";
-			}
-			break;
+			return "Number of predecessors";
 		case SUM_OF_DIRECT_SUCCESSORS_FLOWS:
-			{
-				vector<uint32_t> sumOfDirectSuccessorsFlows = getSumOfSuccessorsFlowsDirect();
-				sumOfDirectSuccessorsFlows = getValuesInOrder(sumOfDirectSuccessorsFlows, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfDirectSuccessorsFlows, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfDirectSuccessorsFlows);
-				parameterDescription = "Sum of direct successors flows";
-			}
-			break;
+			return "Sum of direct successors flows";
 		case SUM_OF_SUCCESSORS_FLOWS:
-			{
-				vector<uint32_t> sumOfSuccessorsFlows = getSumOfSuccessorsFlowsAll();
-				sumOfSuccessorsFlows = getValuesInOrder(sumOfSuccessorsFlows, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfSuccessorsFlows, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfSuccessorsFlows);
-				parameterDescription = "Sum of successors flows";
-			}
-			break;
+			return "Sum of successors flows";
 		case NUMBER_OF_USED_RESOURCES:
-			{
-				vector<uint32_t> numberOfUsedResources = getNumberOfUsedResources();
-				numberOfUsedResources = getValuesInOrder(numberOfUsedResources, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(numberOfUsedResources, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(numberOfUsedResources);
-				parameterDescription = "Number of used resources:";
-			}
-			break;
+			return "Number of used resources:";
 		case SUM_OF_REQUIREMENTS:
-			{
-				vector<uint32_t> sumOfRequirements = getSumOfActivitiesRequirements();
-				sumOfRequirements = getValuesInOrder(sumOfRequirements, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfRequirements, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfRequirements);
-				parameterDescription = "Sum of activity requirements";
-			}
-			break;
+			return "Sum of activity requirements";
 		case SUM_OF_WEIGHTED_REQUIREMENTS:
-			{
-				vector<uint32_t> sumOfWeightedRequirements = getSumOfWeightedActivitiesRequirements();
-				sumOfWeightedRequirements = getValuesInOrder(sumOfWeightedRequirements, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfWeightedRequirements, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfWeightedRequirements);
-				parameterDescription = "Sum of weighted activity requirements";
-			}
-			break;
+			return "Sum of weighted activity requirements";
 		case SUM_OF_DIRECT_SUCCESSORS_REQUIREMENTS:
-			{
-				vector<uint32_t> sumOfDirectSucReq = getSumOfDirectSuccessorsActivitiesRequirements();
-				sumOfDirectSucReq = getValuesInOrder(sumOfDirectSucReq, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfDirectSucReq, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfDirectSucReq);
-				parameterDescription = "Sum of direct successors requirements";
-			}
-			break;
+			return "Sum of direct successors requirements";
 		case SUM_OF_ALL_SUCCESSORS_REQUIREMENTS:
-			{
-				vector<uint32_t> sumOfSucReq = getSumOfAllSuccessorsActivitiesRequirements();
-				sumOfSucReq = getValuesInOrder(sumOfSucReq, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(sumOfSucReq, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(sumOfSucReq);
-				parameterDescription = "Sum of successors requirements";
-			}
-			break;
+			return "Sum of successors requirements";
 		case WEIGHTED_SUM_OF_DIRECT_SUCCESSORS_REQUIREMENTS:
-			{
-				vector<uint32_t> weightedSumOfDirSucReq = getSumOfDirectSuccessorsActivitiesRequirements(true);
-				weightedSumOfDirSucReq = getValuesInOrder(weightedSumOfDirSucReq, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(weightedSumOfDirSucReq, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(weightedSumOfDirSucReq);
-				parameterDescription = "Weighted sum of direct successors requirements";
-			}
-			break;
+			return "Weighted sum of direct successors requirements";
 		case WEIGHTED_SUM_OF_ALL_SUCCESSORS_REQUIREMENTS:
-			{
-				vector<uint32_t> weightedSumOfSucReq = getSumOfAllSuccessorsActivitiesRequirements(true);
-				weightedSumOfSucReq = getValuesInOrder(weightedSumOfSucReq, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(weightedSumOfSucReq, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(weightedSumOfSucReq);
-				parameterDescription = "Weighted sum of successors requirements";
-			}
-			break;
+			return "Weighted sum of successors requirements";
 		case ACTIVITY_FREEDOM:
-			{
-				vector<double> activitiesFreedom = getActivitiesFreedom();
-				activitiesFreedom = getValuesInOrder(activitiesFreedom, scheduleOrder);
-				partOfBody = getScheduleAnalysisLatexBodyElement(activitiesFreedom, colors[parameter % NUMBER_OF_COLORS], yShift);
-				parameterResults.parameterValues = normalizeValues(activitiesFreedom);
-				parameterDescription = "Activities freedom";
-			}
-			break;
+			return "Activities freedom";
 		default:
-			throw runtime_error("getScheduleAnalysisLatexBodyPart(const Param&, uint32_t): Unknown parameter!");
+			throw runtime_error("VisualizerScheduleStatistics::getParameterDescription: Unknown parameter!");
+	}
+}
+
+AnalysisRow VisualizerScheduleStatistics::getScheduleAnalysisRow(const ParameterTable& table, const Parameter& parameter, int32_t yShift) {
+
+	AnalysisRow row;
+	string parameterDescription = getParameterDescription(parameter);
+	ParameterResult parameterResults;
+
+	// The order and the start times are only shown, the other parameters are normalized and saved for the group statistics.
+	if (parameter == ACTIVITY_FREEDOM)	{
+		setRowValues(row, table.activitiesFreedom);
+		parameterResults.parameterValues = normalizeValues(table.activitiesFreedom);
+	} else {
+		setRowValues(row, table.integralColumns[parameter]);
+		if (parameter != ACTIVITY_ID && parameter != ACTIVITY_START_TIME)
+			parameterResults.parameterValues = normalizeValues(table.integralColumns[parameter]);
 	}
 
 	if (parameter != ACTIVITY_ID && parameter != ACTIVITY_START_TIME)	{
 		parameterResults.description = parameterDescription;
 		savedAnalysis.results[parameter] = parameterResults;
 	}
-	line<<"\t\t\\draw (0,"<<boxSize/2.+yShift<<") node[left] {\\bf "<<parameterDescription<<": };";
-	partOfBody.insert(partOfBody.begin(), extractLine(line));
 
-	return partOfBody;
+	row.label = parameterDescription+": ";
+	row.color = colors[parameter % NUMBER_OF_COLORS];
+	row.yShift = yShift;
+	return row;
 }
 
 template <class T>
-vector<T> VisualizerScheduleStatistics::getValuesInOrder(const vector<T>& values, const uint32_t * const& order)	{
-	vector<T> orderValues;
+void VisualizerScheduleStatistics::setRowValues(AnalysisRow& row, const vector<T>& values)	{
+	row.values.assign(values.begin(), values.end());
+	row.integralValues = numeric_limits<T>::is_integer;
+	setRowDetail(row);
+}
+
+void VisualizerScheduleStatistics::setRowDetail(AnalysisRow& row)	{
+	uint32_t numberOfValues = row.values.size();
+	uint32_t numberOfColumns = getNumberOfDrawnColumns(numberOfValues);
+	row.minValues.clear();
+	row.maxValues.clear();
+	if (numberOfColumns < numberOfValues)	{
+		// The columns are split into the bins of (almost) the same size, i.e. the size of the figure is bounded.
+		vector<double> meanValues;
+		for (uint32_t c = 0; c < numberOfColumns; ++c)	{
+			uint32_t firstColumn = (((uint64_t) c)*numberOfValues)/numberOfColumns;
+			uint32_t lastColumn = (((uint64_t) c+1)*numberOfValues)/numberOfColumns;
+			vector<double>::const_iterator first = row.values.begin()+firstColumn, last = row.values.begin()+lastColumn;
+			meanValues.push_back(accumulate(first, last, 0.0)/((double) (lastColumn-firstColumn)));
+			row.minValues.push_back(*min_element(first, last));
+			row.maxValues.push_back(*max_element(first, last));
+		}
+		row.values = meanValues;
+		row.integralValues = false;
+	}
+	row.showValues = (numberOfColumns <= ConfigureScheduleAnalysis::maxNumberOfLabeledColumns);
+}
+
+uint32_t VisualizerScheduleStatistics::getNumberOfDrawnColumns(uint32_t numberOfColumns)	{
+	return min(numberOfColumns, max(ConfigureScheduleAnalysis::maxNumberOfColumns, (uint32_t) 1));
+}
+
+vector<uint32_t> VisualizerScheduleStatistics::getRowTransparencies(const AnalysisRow& row, const vector<double>& values)	{
+	double minValue = *min_element(row.values.begin(), row.values.end());
+	double maxValue = *max_element(row.values.begin(), row.values.end());
+	if (!row.minValues.empty())	{
+		// The binned row is shaded relative to the extremes of its bins.
+		minValue = *min_element(row.minValues.begin(), row.minValues.end());
+		maxValue = *max_element(row.maxValues.begin(), row.maxValues.end());
+	}
+	double range = maxValue-minValue;
+
+	// The constant row (including the binned one) has no range, all its cells are fully transparent.
+	if (!(range > 0))
+		return vector<uint32_t>(values.size(), 0);
+
+	vector<uint32_t> transparencies;
 	for (uint32_t i = 0; i < values.size(); ++i)	{
-		uint32_t activityId = order[i];
-		orderValues.push_back(values[activityId]);
+		// The percentage is scaled before the division, i.e. the exact fractions (e.g. 7/20) are not rounded down.
+		// The value is clamped before the conversion, i.e. the rounding errors cannot leave the range [0, 100].
+		double transparency = floor(100.*(values[i]-minValue)/range);
+		transparencies.push_back((uint32_t) max(0.0, min(transparency, 100.0)));
 	}
-	return orderValues;
+	return transparencies;
 }
 
-template <class T>
-vector<string> VisualizerScheduleStatistics::getScheduleAnalysisLatexBodyElement(const T& values, const char* color, uint32_t yShift)  {
+void VisualizerScheduleStatistics::writeAnalysisRowLatexSource(BufferedWriter& latexBody, const AnalysisRow& row)  {
 	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
-	vector<string> latexBody;
-	typename T::value_type minValue = *min_element(values.begin(), values.end());
-	typename T::value_type maxValue = *max_element(values.begin(), values.end());
-	double unitPitch = (maxValue-minValue)/100.;
+	vector<uint32_t> transparencies = getRowTransparencies(row, row.values);
+	vector<uint32_t> minTransparencies = getRowTransparencies(row, row.minValues);
+	vector<uint32_t> maxTransparencies = getRowTransparencies(row, row.maxValues);
 
 	uint32_t x = 0;
-	for (uint32_t i = 0; i < values.size(); ++i)	{
-		uint32_t transparency = floor((values[i]-minValue)/unitPitch);
-		stringstream line(stringstream::in | stringstream::out);
-		line<<"\t\t\\draw[plainblockstyle, fill="<<color<<"!"<<transparency<<"] ("<<x<<","<<yShift<<") rectangle ";
-		line<<"("<<x+boxSize<<","<<yShift+boxSize<<");";
-		latexBody.push_back(extractLine(line));
-		line<<"\t\t\\draw ("<<x+boxSize/2.<<","<<yShift+boxSize/2.<<") node {\\bf "<<fixed<<setprecision(2)<<values[i]<<"};";
-		latexBody.push_back(extractLine(line));
+	uint32_t yShift = row.yShift;
+	for (uint32_t i = 0; i < row.values.size(); ++i)	{
+		if (row.minValues.empty())	{
+			latexBody<<"\t\t\\draw[plainblockstyle, fill="<<row.color<<"!"<<transparencies[i]<<"] ("<<x<<","<<yShift<<") rectangle ";
+			latexBody<<"("<<x+boxSize<<","<<yShift+boxSize<<");\n";
+		} else {
+			// The bin is drawn as the stripes of the minimum, the mean, and the maximum (from the bottom).
+			uint32_t stripeTransparencies[] = { minTransparencies[i], transparencies[i], maxTransparencies[i] };
+			for (uint32_t k = 0; k < 3; ++k)	{
+				latexBody<<"\t\t\\draw[plainblockstyle, fill="<<row.color<<"!"<<stripeTransparencies[k]<<"] ("<<x<<","<<yShift+k*boxSize/3.<<") rectangle ";
+				latexBody<<"("<<x+boxSize<<","<<yShift+(k+1)*boxSize/3.<<");\n";
+			}
+		}
+		if (row.showValues)	{
+			latexBody<<"\t\t\\draw ("<<x+boxSize/2.<<","<<yShift+boxSize/2.<<") node {\\bf ";
+			if (row.integralValues)
+				latexBody<<(uint32_t) row.values[i];
+			else
+				latexBody.writeFixed(row.values[i], 2);
+			latexBody<<"};\n";
+		}
 		x += boxSize;
 	}
-
-	return latexBody;
 }
 
-vector<string> VisualizerScheduleStatistics::getGroupAnalysisLatexBody(const string& title, vector<InstanceResults> results)	{
-
+void VisualizerScheduleStatistics::drawAnalysisFigure(VectorCanvas& canvas, const AnalysisFigure& figure, double titleFontSize)	{
 	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
-	uint32_t averageWindow = ConfigureScheduleAnalysis::averageWindow;
-	int32_t yShift = (NUMBER_OF_PARAMETERS-2)*(5*boxSize);
-
-	for (vector<InstanceResults>::iterator it = results.begin(); it != results.end(); ++it)	{
-		uint32_t numberOfColumns = it->numberOfColumns;
-		for (uint32_t p = 2; p < NUMBER_OF_PARAMETERS; ++p)	{
-			map<Parameter, ParameterResult>::iterator mit = it->results.find((Parameter) p);
-			if (mit != it->results.end())	{
-				vector<double> newValues;
-				vector<double> values = mit->second.parameterValues;
-				double sumValue = 0;
-				uint32_t counter = 0;
-				for (uint32_t i = 1; i < numberOfColumns; ++i)	{
-					if (counter < averageWindow)	{
-						sumValue += values[i];
-						++counter;
-					} else {
-						double averageValue = sumValue/((double) averageWindow);
-						newValues.push_back(averageValue);
-						sumValue = values[i]; counter = 1;
-					}
+	canvas.drawText(figure.titleX, figure.titleY, figure.title, titleFontSize, true, TEXT_ABOVE);
+	for (vector<AnalysisRow>::const_iterator it = figure.rows.begin(); it != figure.rows.end(); ++it)	{
+		if (!it->heading.empty())
+			canvas.drawText(0, it->yShift+boxSize, it->heading, LARGE_FONT, true, TEXT_ABOVE);
+		canvas.drawText(0, it->yShift+boxSize/2., it->label, NORMAL_FONT, true, TEXT_LEFT);
+
+		vector<uint32_t> transparencies = getRowTransparencies(*it, it->values);
+		vector<uint32_t> minTransparencies = getRowTransparencies(*it, it->minValues);
+		vector<uint32_t> maxTransparencies = getRowTransparencies(*it, it->maxValues);
+		for (uint32_t i = 0; i < it->values.size(); ++i)	{
+			double x = i*boxSize;
+			if (it->minValues.empty())	{
+				canvas.drawRectangle(x, it->yShift, x+boxSize, it->yShift+boxSize, VectorCanvas::getColor(it->color, transparencies[i]), THICK_LINE);
+			} else {
+				uint32_t stripeTransparencies[] = { minTransparencies[i], transparencies[i], maxTransparencies[i] };
+				for (uint32_t k = 0; k < 3; ++k)	{
+					canvas.drawRectangle(x, it->yShift+k*boxSize/3., x+boxSize, it->yShift+(k+1)*boxSize/3.,
+							VectorCanvas::getColor(it->color, stripeTransparencies[k]), THICK_LINE);
 				}
-				mit->second.parameterValues = newValues;
+			}
+
+			if (it->showValues)	{
+				char value[32];
+				if (it->integralValues)
+					snprintf(value, sizeof(value), "%u", (uint32_t) it->values[i]);
+				else
+					snprintf(value, sizeof(value), "%.2f", it->values[i]);
+				canvas.drawText(x+boxSize/2., it->yShift+boxSize/2., value, NORMAL_FONT, true);
 			}
 		}
-		it->numberOfColumns = (numberOfColumns-2)/averageWindow;
 	}
+}
+
+AnalysisFigure VisualizerScheduleStatistics::getGroupAnalysisFigure(const string& title, const GroupStatistics& statistics)	{
 
-	vector<string> latexBody;
-	if (results.size() >= 2)	{
-		uint32_t numberOfColumns = results[0].numberOfColumns;
-		stringstream line(stringstream::in | stringstream::out);
-		line<<"\t\t\\draw ("<<numberOfColumns*boxSize/2.<<","<<yShift<<") node[above] {\\bf\\Huge "<<title<<"};";
-		latexBody.push_back(extractLine(line));
+	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
+	int32_t yShift = (NUMBER_OF_PARAMETERS-2)*(5*boxSize);
+
+	AnalysisFigure figure;
+	if (statistics.getNumberOfInstances() >= 2)	{
+		uint32_t numberOfColumns = statistics.getNumberOfColumns();
+		figure.title = title;
+		figure.titleX = getNumberOfDrawnColumns(numberOfColumns)*boxSize/2.;
+		figure.titleY = yShift;
 		for (uint32_t p = 2; p < NUMBER_OF_PARAMETERS; ++p)	{
-			string parameterDescription;
+			string parameterDescription = statistics.getDescription((Parameter) p);
+			const vector<ColumnStatistics>& columns = statistics.getColumns((Parameter) p);
 			vector<double> meanValues, medianValues, deviationValues, variationValues;
 			for (uint32_t i = 0; i < numberOfColumns; ++i)	{
-				double columnSum = 0;
-				vector<double> columnValues;
-				for (vector<InstanceResults>::const_iterator it = results.begin(); it != results.end(); ++it)	{
-					map<Parameter, ParameterResult>::const_iterator mit;
-					if ((mit = it->results.find((Parameter) p)) != it->results.end())	{
-						double value = mit->second.parameterValues[i];
-						columnSum += value;
-						columnValues.push_back(value);
-						if (parameterDescription.empty())
-							parameterDescription = mit->second.description;
-					}
+				double mean = 0, median = 0, standartDeviation = 0;
+				if (i < columns.size())	{
+					mean = columns[i].getMean();
+					median = columns[i].getMedian();
+					standartDeviation = columns[i].getStandardDeviation();
 				}
 
-				uint32_t numberOfRows = results.size();
-				double mean = columnSum/((double) numberOfRows);
-				sort(columnValues.begin(), columnValues.end());
-				double median = 0;
-			        if ((numberOfRows % 2) == 0)
-					median = (columnValues[numberOfRows/2]+columnValues[numberOfRows/2-1])/2.;
-				else
-					median = columnValues[numberOfRows/2];
-
-				double standartDeviation = 0;
-				for (vector<InstanceResults>::const_iterator it = results.begin(); it != results.end(); ++it)	{
-					map<Parameter, ParameterResult>::const_iterator mit;
-					if ((mit = it->results.find((Parameter) p)) != it->results.end())	{
-						double value = mit->second.parameterValues[i];
-						standartDeviation += (value-mean)*(value-mean);
-					}
-				}
-				standartDeviation /= (double) numberOfRows-1;
-				standartDeviation = sqrt(standartDeviation);
 				double variationCoefficient = 0;
 				if (mean > 0)
 					variationCoefficient = (standartDeviation/mean)*100;
@@ -354,30 +339,37 @@ vector<string> VisualizerScheduleStatistics::getGroupAnalysisLatexBody(const str
 				variationValues.push_back(variationCoefficient);
 			}
 
-			line<<"\t\t\\draw ("<<0<<","<<yShift<<") node[above] {\\bf\\large "<<parameterDescription<<"};"<<endl;
-			latexBody.push_back(extractLine(line)); yShift -= boxSize;
-			line<<"\t\t\\draw ("<<0<<","<<yShift+boxSize/2.<<") node[left] {\\bf mean:};"<<endl;
-			latexBody.push_back(extractLine(line)); 
-			vector<string> latexLines = getScheduleAnalysisLatexBodyElement(meanValues, colors[p % NUMBER_OF_COLORS], yShift);
-			latexBody.insert(latexBody.end(), latexLines.begin(), latexLines.end()); yShift -= boxSize;
-			line<<"\t\t\\draw ("<<0<<","<<yShift+boxSize/2.<<") node[left] {\\bf median:};"<<endl;
-			latexBody.push_back(extractLine(line)); 
-			latexLines = getScheduleAnalysisLatexBodyElement(medianValues, colors[p % NUMBER_OF_COLORS], yShift);
-			latexBody.insert(latexBody.end(), latexLines.begin(), latexLines.end()); yShift -= boxSize;
-			line<<"\t\t\\draw ("<<0<<","<<yShift+boxSize/2.<<") node[left] {\\bf standart deviation:};"<<endl;
-			latexBody.push_back(extractLine(line)); 
-			latexLines = getScheduleAnalysisLatexBodyElement(deviationValues, colors[p % NUMBER_OF_COLORS], yShift);
-			latexBody.insert(latexBody.end(), latexLines.begin(), latexLines.end()); yShift -= boxSize;
-			line<<"\t\t\\draw ("<<0<<","<<yShift+boxSize/2.<<") node[left] {\\bf variation coefficient:};"<<endl;
-			latexBody.push_back(extractLine(line)); 
-			latexLines = getScheduleAnalysisLatexBodyElement(variationValues, colors[p % NUMBER_OF_COLORS], yShift);
-			latexBody.insert(latexBody.end(), latexLines.begin(), latexLines.end()); yShift -= boxSize;
+			const char* labels[] = { "mean:", "median:", "standart deviation:", "variation coefficient:" };
+			vector<double>* values[] = { &meanValues, &medianValues, &deviationValues, &variationValues };
+			yShift -= boxSize;
+			for (uint32_t k = 0; k < 4; ++k)	{
+				AnalysisRow row;
+				if (k == 0)
+					row.heading = parameterDescription;
+				row.label = labels[k];
+				setRowValues(row, *values[k]);
+				row.color = colors[p % NUMBER_OF_COLORS];
+				row.yShift = yShift;
+				figure.rows.push_back(row);
+				yShift -= boxSize;
+			}
 		}
 	}	else	{
 		throw runtime_error("VisualizerScheduleStatistics::writeGroupStatistics: Insufficient data of results structure!");
 	}
-	
-	return latexBody;
+
+	return figure;
+}
+
+void VisualizerScheduleStatistics::writeGroupAnalysisLatexBody(BufferedWriter& latexBody, const AnalysisFigure& figure)	{
+	uint32_t boxSize = ConfigureScheduleAnalysis::boxSize;
+	latexBody<<"\t\t\\draw ("<<figure.titleX<<","<<figure.titleY<<") node[above] {\\bf\\Huge "<<figure.title<<"};\n";
+	for (vector<AnalysisRow>::const_iterator it = figure.rows.begin(); it != figure.rows.end(); ++it)	{
+		if (!it->heading.empty())
+			latexBody<<"\t\t\\draw ("<<0<<","<<it->yShift+boxSize<<") node[above] {\\bf\\large "<<it->heading<<"};\n\n";
+		latexBody<<"\t\t\\draw ("<<0<<","<<it->yShift+boxSize/2.<<") node[left] {\\bf "<<it->label<<"};\n\n";
+		writeAnalysisRowLatexSource(latexBody, *it);
+	}
 }
 
 template <class T>
@@ -389,137 +381,61 @@ vector<double> VisualizerScheduleStatistics::normalizeValues(const vector<T>& va
 	return normalized;
 }
 
-vector<uint32_t> VisualizerScheduleStatistics::getNumberOfAllSuccessors() const	{
-	vector<uint32_t> numberOfAllSuccessors;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)
-		numberOfAllSuccessors.push_back(getNumberOfAllRelatedActivities(i, numberOfSuccessors, successors));
-	return numberOfAllSuccessors;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getNumberOfAllPredecessors() const	{
-	vector<uint32_t> numberOfAllPredecessors;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)
-		numberOfAllPredecessors.push_back(getNumberOfAllRelatedActivities(i, numberOfPredecessors, predecessors));
-	return numberOfAllPredecessors;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getAllRelatedActivities(uint32_t activityId, uint32_t *numberOfRelated, uint32_t **related) const	{
-	vector<uint32_t> relatedActivities;
-	bool *activitiesSet = new bool[numberOfActivities];
-	fill(activitiesSet, activitiesSet+numberOfActivities, false);
-
-	for (uint32_t j = 0; j < numberOfRelated[activityId]; ++j)	{
-		activitiesSet[related[activityId][j]] = true;
-		vector<uint32_t> indirectRelated = getAllRelatedActivities(related[activityId][j], numberOfRelated, related);
-		for (vector<uint32_t>::const_iterator it = indirectRelated.begin(); it != indirectRelated.end(); ++it)
-			activitiesSet[*it] = true;
-	}
-
-	for (uint32_t id = 0; id < numberOfActivities; ++id)	{
-		if (activitiesSet[id] == true)
-			relatedActivities.push_back(id);
-	}
-	
-	delete[] activitiesSet;
-	return relatedActivities;
-}
-
-uint32_t VisualizerScheduleStatistics::getNumberOfAllRelatedActivities(uint32_t activityId, uint32_t *numberOfRelated, uint32_t **related) const	{
-	return getAllRelatedActivities(activityId, numberOfRelated, related).size();
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfSuccessorsFlowsDirect() const	{
-	vector<uint32_t> sumOfSuccessorsFlowsDirect;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t sumOfFlows = 0;
-		for (uint32_t j = 0; j < numberOfSuccessors[i]; ++j)
-			sumOfFlows += activitiesDuration[successors[i][j]];
-		sumOfSuccessorsFlowsDirect.push_back(sumOfFlows);
-	}
-	return sumOfSuccessorsFlowsDirect;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfSuccessorsFlowsAll() const	{
-	vector<uint32_t> sumOfSuccessorsFlowsAll;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t sumOfFlows = 0;
-		vector<uint32_t> allSuccessors = getAllRelatedActivities(i, numberOfSuccessors, successors);
-		for (vector<uint32_t>::const_iterator it = allSuccessors.begin(); it != allSuccessors.end(); ++it)
-			sumOfFlows += activitiesDuration[*it];
-		sumOfSuccessorsFlowsAll.push_back(sumOfFlows);
+ParameterTable VisualizerScheduleStatistics::getParameterTable() const	{
+	ParameterTable table;
+	for (uint32_t p = 0; p < NUMBER_OF_PARAMETERS; ++p)	{
+		if (p != ACTIVITY_FREEDOM)
+			table.integralColumns[p].resize(numberOfActivities);
 	}
-	return sumOfSuccessorsFlowsAll;
-}
+	table.activitiesFreedom.resize(numberOfActivities);
 
-vector<uint32_t> VisualizerScheduleStatistics::getNumberOfUsedResources() const	{
-	vector<uint32_t> numberOfUsedResources;
+	// The first pass sums the requirements of each activity, the sums over the successors are composed of them.
+	vector<uint32_t> numberOfUsedResources(numberOfActivities, 0);
+	vector<uint32_t> sumOfRequirements(numberOfActivities, 0), sumOfWeightedRequirements(numberOfActivities);
 	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t usedResourcesCounter = 0;
+		const uint32_t *activityRequirements = requiredResources+i*numberOfResources;
 		for (uint32_t r = 0; r < numberOfResources; ++r)	{
-			if (requiredResources[i][r] > 0)
-				++usedResourcesCounter;
-		}
-		numberOfUsedResources.push_back(usedResourcesCounter);
-	}
-	return numberOfUsedResources;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfActivitiesRequirements() const	{
-	vector<uint32_t> sumOfActivitiesRequirements;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t sumOfRequirements = 0;
-		for (uint32_t r = 0; r < numberOfResources; ++r)
-			sumOfRequirements += requiredResources[i][r];
-		sumOfActivitiesRequirements.push_back(sumOfRequirements);
-	}
-	return sumOfActivitiesRequirements;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfWeightedActivitiesRequirements() const	{
-	vector<uint32_t> sumOfWeightedActivitiesRequirements = getSumOfActivitiesRequirements();
-	for (uint32_t i = 0; i < numberOfActivities; ++i)
-		sumOfWeightedActivitiesRequirements[i] *= activitiesDuration[i];
-	return sumOfWeightedActivitiesRequirements;
-}
-
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfDirectSuccessorsActivitiesRequirements(bool weighted) const	{
-	vector<uint32_t> sumOfDirectSuccessorsActivitiesRequirements;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t sumOfRequirements = 0;
-		for (uint32_t j = 0; j < numberOfSuccessors[i]; ++j)	{
-			uint32_t successorSumReq = accumulate(requiredResources[successors[i][j]],
-					requiredResources[successors[i][j]]+numberOfResources, 0);
-			sumOfRequirements += successorSumReq*(weighted == true ? activitiesDuration[successors[i][j]] : 1);
+			sumOfRequirements[i] += activityRequirements[r];
+			if (activityRequirements[r] > 0)
+				++numberOfUsedResources[i];
 		}
-		sumOfDirectSuccessorsActivitiesRequirements.push_back(sumOfRequirements);
+		sumOfWeightedRequirements[i] = sumOfRequirements[i]*activitiesDuration[i];
 	}
-	return sumOfDirectSuccessorsActivitiesRequirements;
-}
 
-vector<uint32_t> VisualizerScheduleStatistics::getSumOfAllSuccessorsActivitiesRequirements(bool weighted) const	{
-	vector<uint32_t> sumOfAllSuccessorsActivitiesRequirements;
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		uint32_t sumOfRequirements = 0;
-		vector<uint32_t> allSuccessors = getAllRelatedActivities(i, numberOfSuccessors, successors);
-		for (vector<uint32_t>::const_iterator it = allSuccessors.begin(); it != allSuccessors.end(); ++it)	{
-			uint32_t successorSumReq = accumulate(requiredResources[*it], requiredResources[*it]+numberOfResources, 0);
-			sumOfRequirements += successorSumReq*(weighted == true ? activitiesDuration[*it] : 1);
+	// The second pass fills all the columns at once in the schedule order.
+	double cpl = criticalPathLength;
+	for (uint32_t k = 0; k < numberOfActivities; ++k)	{
+		uint32_t activityId = scheduleOrder[k];
+		uint32_t sumOfFlows = 0, sumOfDirectRequirements = 0, weightedSumOfDirectRequirements = 0;
+		for (uint32_t j = successorsIndex[activityId]; j < successorsIndex[activityId+1]; ++j)	{
+			uint32_t successorId = successors[j];
+			sumOfFlows += activitiesDuration[successorId];
+			sumOfDirectRequirements += sumOfRequirements[successorId];
+			weightedSumOfDirectRequirements += sumOfWeightedRequirements[successorId];
 		}
-		sumOfAllSuccessorsActivitiesRequirements.push_back(sumOfRequirements);
-	}
-	return sumOfAllSuccessorsActivitiesRequirements;
-}
-
-vector<double> VisualizerScheduleStatistics::getActivitiesFreedom() const	{
-	vector<double> activitiesFreedom;
 
-	double cpl = distanceMatrix[0][numberOfActivities-1];
-	for (uint32_t i = 0; i < numberOfActivities; ++i)	{
-		double l1 = distanceMatrix[0][i];
-		double l2 = distanceMatrix[i][numberOfActivities-1];
-		double freedomCoefficient = (cpl-l1-l2)/cpl;
-		activitiesFreedom.push_back(freedomCoefficient);
+		table.integralColumns[ACTIVITY_ID][k] = activityId;
+		table.integralColumns[ACTIVITY_START_TIME][k] = startTimesById[activityId];
+		table.integralColumns[ACTIVITY_DURATION][k] = activitiesDuration[activityId];
+		table.integralColumns[NUMBER_OF_DIRECT_SUCCESSORS][k] = numberOfSuccessors[activityId];
+		table.integralColumns[NUMBER_OF_DIRECT_PREDECESSORS][k] = numberOfPredecessors[activityId];
+		table.integralColumns[NUMBER_OF_ALL_SUCCESSORS][k] = allSuccessors.getNumberOfRelated(activityId);
+		table.integralColumns[NUMBER_OF_ALL_PREDECESSORS][k] = allPredecessors.getNumberOfRelated(activityId);
+		table.integralColumns[SUM_OF_DIRECT_SUCCESSORS_FLOWS][k] = sumOfFlows;
+		table.integralColumns[SUM_OF_SUCCESSORS_FLOWS][k] = allSuccessors.getSumOfRelated(activityId, activitiesDuration);
+		table.integralColumns[NUMBER_OF_USED_RESOURCES][k] = numberOfUsedResources[activityId];
+		table.integralColumns[SUM_OF_REQUIREMENTS][k] = sumOfRequirements[activityId];
+		table.integralColumns[SUM_OF_WEIGHTED_REQUIREMENTS][k] = sumOfWeightedRequirements[activityId];
+		table.integralColumns[SUM_OF_DIRECT_SUCCESSORS_REQUIREMENTS][k] = sumOfDirectRequirements;
+		table.integralColumns[SUM_OF_ALL_SUCCESSORS_REQUIREMENTS][k] = allSuccessors.getSumOfRelated(activityId, &sumOfRequirements[0]);
+		table.integralColumns[WEIGHTED_SUM_OF_DIRECT_SUCCESSORS_REQUIREMENTS][k] = weightedSumOfDirectRequirements;
+		table.integralColumns[WEIGHTED_SUM_OF_ALL_SUCCESSORS_REQUIREMENTS][k] = allSuccessors.getSumOfRelated(activityId, &sumOfWeightedRequirements[0]);
+
+		// The freedom is a slack of the activity relative to the critical path length.
+		// The slack is computed in double, i.e. the latest start time below the earliest one does not wrap around.
+		double slack = max(((double) latestStartTimes[activityId])-earliestStartTimes[activityId], 0.0);
+		table.activitiesFreedom[k] = (cpl > 0 ? slack/cpl : 0.0);
 	}
 
-	return activitiesFreedom;
+	return table;
 }
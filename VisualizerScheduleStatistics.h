@@ -21,6 +21,9 @@
 #include <string>
 #include <vector>
 #include <stdint.h>
+#include "DefaultParameters.h"
+#include "TransitiveClosure.h"
+#include "VectorCanvas.h"
 #include "Visualizer.h"
 
 #define NUMBER_OF_PARAMETERS 17
@@ -44,41 +47,74 @@ struct InstanceResults	{
 	std::map<Parameter, ParameterResult> results;
 };
 
+/*
+ * Row of colored boxes in the statistics figures, the geometry is shared by the TikZ and vector outputs.
+ */
+struct AnalysisRow	{
+	std::string heading;
+	std::string label;
+	std::vector<double> values;
+	// The level of detail of the long rows, the values are the means of the bins of the columns then.
+	std::vector<double> minValues, maxValues;
+	bool integralValues;
+	bool showValues;
+	const char* color;
+	int32_t yShift;
+};
+
+/*
+ * Values of all the visualized parameters in the schedule order stored as a structure of arrays.
+ * The activity freedom is the only real parameter, its integral column is left empty.
+ */
+struct ParameterTable	{
+	std::vector<uint32_t> integralColumns[NUMBER_OF_PARAMETERS];
+	std::vector<double> activitiesFreedom;
+};
+
+struct AnalysisFigure	{
+	std::string title;
+	double titleX, titleY;
+	std::vector<AnalysisRow> rows;
+};
+
+class GroupStatistics;
+
 class VisualizerScheduleStatistics : public Visualizer {
 	 public:
 
-		VisualizerScheduleStatistics(const std::string& file) : Visualizer(file) { };
-		void writeScheduleStatistics(const std::string& file);
+		VisualizerScheduleStatistics(const ScheduleInstance& instance);
+		void writeScheduleStatistics(const std::string& file, FigureFormat format = TIKZ_FORMAT);
 		InstanceResults getScheduleAnalysisData() const { return savedAnalysis; }
-		static void writeGroupStatistics(const std::string& file, const std::vector<InstanceResults>& results);
+		// The parameters of the statistics figure are written to the columnar binary file, see AnalysisDataFile.
+		void writeAnalysisData(const std::string& file);
+		static void writeGroupStatistics(const std::string& file, const GroupStatistics& statistics, FigureFormat format = TIKZ_FORMAT);
+		static std::string getParameterDescription(Parameter parameter);
 		
 	private:
 
-		std::vector<std::string> getScheduleAnalysisLatexBody(std::string instanceTitle);
-		std::vector<std::string> getScheduleAnalysisLatexBodyPart(const Parameter& parameter, uint32_t yShift);
-		static std::vector<std::string> getGroupAnalysisLatexBody(const std::string& title, std::vector<InstanceResults> results);
+		AnalysisFigure getScheduleAnalysisFigure(std::string instanceTitle);
+		AnalysisRow getScheduleAnalysisRow(const ParameterTable& table, const Parameter& parameter, int32_t yShift);
+		ParameterTable getParameterTable() const;
+		static AnalysisFigure getGroupAnalysisFigure(const std::string& title, const GroupStatistics& statistics);
+
+		static void writeScheduleAnalysisLatexBody(BufferedWriter& latexBody, const AnalysisFigure& figure);
+		static void writeGroupAnalysisLatexBody(BufferedWriter& latexBody, const AnalysisFigure& figure);
+		static void writeAnalysisRowLatexSource(BufferedWriter& latexBody, const AnalysisRow& row);
+		static void drawAnalysisFigure(VectorCanvas& canvas, const AnalysisFigure& figure, double titleFontSize);
+		// The transparencies of the given values (the values, the minima, or the maxima of the row) relative to the range of the row.
+		static std::vector<uint32_t> getRowTransparencies(const AnalysisRow& row, const std::vector<double>& values);
+		static void setRowDetail(AnalysisRow& row);
+		static uint32_t getNumberOfDrawnColumns(uint32_t numberOfColumns);
 
 		template <class T>
-		static std::vector<T> getValuesInOrder(const std::vector<T>& values, const uint32_t * const& order);
-		template <class T>
-		static std::vector<std::string> getScheduleAnalysisLatexBodyElement(const T& values, const char* color, uint32_t yShift);
+		static void setRowValues(AnalysisRow& row, const std::vector<T>& values);
 		template <class T>
 		static std::vector<double> normalizeValues(const std::vector<T>& values);
-
-		std::vector<uint32_t> getNumberOfAllSuccessors() const;
-		std::vector<uint32_t> getNumberOfAllPredecessors() const;
-		std::vector<uint32_t> getAllRelatedActivities(uint32_t activityId, uint32_t *numberOfRelated, uint32_t **related) const;
-		uint32_t getNumberOfAllRelatedActivities(uint32_t activityId, uint32_t *numberOfRelated, uint32_t **related) const;
-		std::vector<uint32_t> getSumOfSuccessorsFlowsDirect() const;
-		std::vector<uint32_t> getSumOfSuccessorsFlowsAll() const;
-		std::vector<uint32_t> getNumberOfUsedResources() const;
-		std::vector<uint32_t> getSumOfActivitiesRequirements() const;
-		std::vector<uint32_t> getSumOfWeightedActivitiesRequirements() const;
-		std::vector<uint32_t> getSumOfDirectSuccessorsActivitiesRequirements(bool weighted = false) const;
-		std::vector<uint32_t> getSumOfAllSuccessorsActivitiesRequirements(bool weighted = false) const;
-		std::vector<double> getActivitiesFreedom() const;
 		
 		InstanceResults savedAnalysis;
+		ParameterTable parameterTable;
+		// Closures of the precedence relation, computed once per instance.
+		TransitiveClosure allSuccessors, allPredecessors;
 };
 
 #endif
@@ -0,0 +1,178 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include "WorkerPool.h"
+
+#ifdef __GNUC__
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+WorkerPool::WorkerPool(uint32_t numberOfThreads) : terminate(false)	{
+	#ifdef __GNUC__
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&jobQueued, NULL);
+	pthread_cond_init(&jobFinished, NULL);
+	// The waiting thread is the last worker.
+	for (uint32_t t = 1; t < numberOfThreads; ++t)	{
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, workerThread, this) != 0)
+			break;
+		threads.push_back(thread);
+	}
+	#endif
+}
+
+WorkerPool::~WorkerPool()	{
+	#ifdef __GNUC__
+	lock();
+	terminate = true;
+	pthread_cond_broadcast(&jobQueued);
+	unlock();
+	for (vector<pthread_t>::const_iterator it = threads.begin(); it != threads.end(); ++it)
+		pthread_join(*it, NULL);
+	pthread_cond_destroy(&jobFinished);
+	pthread_cond_destroy(&jobQueued);
+	pthread_mutex_destroy(&mutex);
+	#endif
+}
+
+void WorkerPool::submit(Job *job, JobGroup& group)	{
+	lock();
+	if (group.queuedJobs.empty())
+		activeGroups.push_back(&group);
+	group.queuedJobs.push_back(job);
+	++group.numberOfUnfinishedJobs;
+	#ifdef __GNUC__
+	pthread_cond_signal(&jobQueued);
+	#endif
+	unlock();
+}
+
+void WorkerPool::wait(JobGroup& group)	{
+	lock();
+	while (group.numberOfUnfinishedJobs > 0)	{
+		Job *job = popJob(&group);
+		if (job != NULL)	{
+			unlock();
+			executeJob(job, &group);
+			lock();
+		} else {
+			// The remaining jobs of the group are being processed by other threads.
+			#ifdef __GNUC__
+			pthread_cond_wait(&jobFinished, &mutex);
+			#endif
+		}
+	}
+	unlock();
+}
+
+void WorkerPool::cancel(JobGroup& group)	{
+	lock();
+	if (!group.queuedJobs.empty())	{
+		for (deque<Job*>::const_iterator it = group.queuedJobs.begin(); it != group.queuedJobs.end(); ++it)
+			delete *it;
+		group.numberOfUnfinishedJobs -= group.queuedJobs.size();
+		group.queuedJobs.clear();
+		activeGroups.erase(find(activeGroups.begin(), activeGroups.end(), &group));
+		#ifdef __GNUC__
+		pthread_cond_broadcast(&jobFinished);
+		#endif
+	}
+	unlock();
+}
+
+uint32_t WorkerPool::getNumberOfCores()	{
+	#ifdef __GNUC__
+	long numberOfCores = sysconf(_SC_NPROCESSORS_ONLN);
+	return (numberOfCores > 0 ? numberOfCores : 1);
+	#else
+	return 1;
+	#endif
+}
+
+void* WorkerPool::workerThread(void *poolPtr)	{
+	WorkerPool *pool = (WorkerPool*) poolPtr;
+	#ifdef __GNUC__
+	pool->lock();
+	while (!pool->terminate)	{
+		if (!pool->activeGroups.empty())	{
+			JobGroup *group = pool->activeGroups.back();
+			Job *job = pool->popJob(group);
+			pool->unlock();
+			pool->executeJob(job, group);
+			pool->lock();
+		} else {
+			pthread_cond_wait(&pool->jobQueued, &pool->mutex);
+		}
+	}
+	pool->unlock();
+	#endif
+	return NULL;
+}
+
+Job* WorkerPool::popJob(JobGroup *group)	{
+	// It has to be called with the locked mutex.
+	if (group->queuedJobs.empty())
+		return NULL;
+
+	Job *job = group->queuedJobs.front();
+	group->queuedJobs.pop_front();
+	if (group->queuedJobs.empty())
+		activeGroups.erase(find(activeGroups.begin(), activeGroups.end(), group));
+
+	return job;
+}
+
+void WorkerPool::executeJob(Job *job, JobGroup *group)	{
+	string errorMessage;
+	bool failed = false;
+	try {
+		job->run();
+	} catch (exception& e)	{
+		errorMessage = e.what();
+		failed = true;
+	} catch (...)	{
+		errorMessage = "WorkerPool::executeJob: Unknown exception!";
+		failed = true;
+	}
+	delete job;
+
+	lock();
+	if (failed)
+		group->errors.push_back(errorMessage);
+	--group->numberOfUnfinishedJobs;
+	#ifdef __GNUC__
+	pthread_cond_broadcast(&jobFinished);
+	#endif
+	unlock();
+}
+
+void WorkerPool::lock()	{
+	#ifdef __GNUC__
+	pthread_mutex_lock(&mutex);
+	#endif
+}
+
+void WorkerPool::unlock()	{
+	#ifdef __GNUC__
+	pthread_mutex_unlock(&mutex);
+	#endif
+}
@@ -0,0 +1,98 @@
+/*
+	This file is part of the RCPSPVisualizer program.
+
+	RCPSPVisualizer is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	RCPSPVisualizer is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with RCPSPVisualizer. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#ifdef __GNUC__
+#include <pthread.h>
+#endif
+
+class Job {
+	public:
+		virtual ~Job() { };
+		virtual void run() = 0;
+};
+
+/*
+ * Set of jobs that is waited for together. The error messages of the failed jobs are collected.
+ */
+class JobGroup {
+
+	friend class WorkerPool;
+
+	public:
+
+		JobGroup() : numberOfUnfinishedJobs(0) { };
+		const std::vector<std::string>& getErrors() const { return errors; }
+
+	private:
+
+		uint32_t numberOfUnfinishedJobs;
+		std::deque<Job*> queuedJobs;
+		std::vector<std::string> errors;
+};
+
+/*
+ * Fixed-size pool of threads. The thread that waits for a group executes the queued jobs
+ * of the group as well, i.e. the pool with one thread processes all the jobs sequentially
+ * in the waiting thread.
+ */
+class WorkerPool {
+	public:
+
+		WorkerPool(uint32_t numberOfThreads);
+		~WorkerPool();
+
+		// The pool takes the ownership of the job.
+		void submit(Job *job, JobGroup& group);
+		void wait(JobGroup& group);
+		// The queued jobs of the group are discarded, the running jobs are finished.
+		void cancel(JobGroup& group);
+
+		static uint32_t getNumberOfCores();
+
+	private:
+
+		WorkerPool(const WorkerPool&);
+		WorkerPool& operator=(const WorkerPool&);
+
+		static void* workerThread(void *pool);
+		Job* popJob(JobGroup *group);
+		void executeJob(Job *job, JobGroup *group);
+
+		void lock();
+		void unlock();
+
+		bool terminate;
+		// Groups with queued jobs, the most recently activated group is served first.
+		std::deque<JobGroup*> activeGroups;
+
+		#ifdef __GNUC__
+		pthread_mutex_t mutex;
+		pthread_cond_t jobQueued;
+		pthread_cond_t jobFinished;
+		std::vector<pthread_t> threads;
+		#endif
+};
+
+#endif
+